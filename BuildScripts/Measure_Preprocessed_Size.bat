@@ -0,0 +1,45 @@
+@echo off
+setlocal EnableDelayedExpansion
+
+rem Preprocess a translation unit which includes just one header and print its size, to see
+rem how much each Reflect header costs every file which includes it.
+rem Run from a "Developer Command Prompt for VS" so cl.exe is on the path.
+rem Any arguments are extra headers to measure, e.g. one of your reflected headers:
+rem     Measure_Preprocessed_Size.bat ..\ReflectTest\src\TestStrcuts.h
+
+set includeDir=%cd%\..\Reflect\inc
+set tempDir=%cd%\tempPreprocess
+if not exist "%tempDir%" mkdir "%tempDir%"
+
+echo Preprocessed size of a translation unit including:
+call :Measure "ReflectFwd.h (generated headers)" ReflectFwd.h
+call :Measure "Generated header includes before ReflectFwd.h" ReflectStructs.h Core/Util.h Core/TypeRegistry.h Core/StaticReflect.h
+call :Measure "ReflectStructs.h" ReflectStructs.h
+call :Measure "Core/TypeRegistry.h (generated .cpp)" Core/TypeRegistry.h
+call :Measure "Reflect.h" Reflect.h
+
+for %%H in (%*) do (
+    call :Measure "%%~nxH" "%%~fH"
+)
+
+RMDIR /s /q "%tempDir%"
+goto :eof
+
+rem :Measure <label> <header>...
+:Measure
+set label=%~1
+set source=%tempDir%\measure.cpp
+type nul > "%source%"
+shift
+:MeasureArgs
+if "%~1" == "" goto MeasureRun
+echo #include "%~1">> "%source%"
+shift
+goto MeasureArgs
+
+:MeasureRun
+cl /nologo /std:c++17 /EP /TP /I"%includeDir%" "%source%" > "%tempDir%\measure.i" 2>nul
+for %%A in ("%tempDir%\measure.i") do set bytes=%%~zA
+for /f %%L in ('find /c /v "" ^< "%tempDir%\measure.i"') do set lines=%%L
+echo   %label%: !bytes! bytes, !lines! lines
+goto :eof
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Core/Core.h"
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <type_traits>
+
+namespace Reflect
+{
+	/// <summary>
+	/// Growable in memory buffer the generated code is written into. Append takes any number of
+	/// string/number pieces and copies them straight into the buffer, so no temporary strings are
+	/// built. The finished buffer is written to disk in one go.
+	/// Example: emitter.Append("\tstatic size_t __REFLECT__", member.Name, "();\\\n");
+	/// </summary>
+	class CodeEmitter
+	{
+	public:
+		static constexpr size_t DefaultReserve = 16 * 1024;
+
+		CodeEmitter(size_t reserve = DefaultReserve)
+		{
+			m_buffer.reserve(reserve);
+		}
+
+		template<typename... Args>
+		CodeEmitter& Append(const Args&... args)
+		{
+			(AppendPiece(args), ...);
+			return *this;
+		}
+
+		void Reserve(size_t size) { m_buffer.reserve(size); }
+		void Clear() { m_buffer.clear(); }
+
+		std::string_view View() const { return m_buffer; }
+		/// <summary>
+		/// Move the buffer out of the emitter, leaving it empty.
+		/// </summary>
+		std::string Release() { return std::move(m_buffer); }
+		size_t Size() const { return m_buffer.size(); }
+
+		/// <summary>
+		/// Replace the contents of 'filePath' with the buffer. Returns false if the file could not be written.
+		/// </summary>
+		REFLECT_API bool WriteToFile(const std::string& filePath) const;
+
+	private:
+		void AppendPiece(std::string_view str) { m_buffer.append(str.data(), str.size()); }
+		void AppendPiece(const std::string& str) { m_buffer.append(str); }
+		void AppendPiece(const char* str) { AppendPiece(std::string_view(str)); }
+		void AppendPiece(char c) { m_buffer.push_back(c); }
+
+		template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>>>
+		void AppendPiece(T value)
+		{
+			char buffer[24];
+			std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			m_buffer.append(buffer, result.ptr);
+		}
+
+	private:
+		std::string m_buffer;
+	};
+}
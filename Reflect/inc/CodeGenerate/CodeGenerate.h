@@ -2,7 +2,9 @@
 
 #include "Core/Core.h"
 #include "ReflectStructs.h"
-#include<fstream>
+#include "CodeGenerate/CodeEmitter.h"
+#include <mutex>
+#include <unordered_map>
 
 namespace Reflect
 {
@@ -15,11 +17,52 @@ namespace Reflect
 		REFLECT_API CodeGenerate();
 		REFLECT_API ~CodeGenerate();
 
+		/// <summary>
+		/// Generate and write the code for a single parsed file. Can be called from several threads at once.
+		/// When unity_files is set the .cpp code is kept until WriteUnityFiles is called.
+		/// </summary>
 		REFLECT_API void Reflect(const FileParsedData& data, const ReflectAddtionalOptions& addtionalOptions);
-		REFLECT_API static void IncludeHeader(const std::string& headerToInclude, std::ofstream& file, bool windowsInclude = false);
+		/// <summary>
+		/// Write the unity .cpp files for every directory passed to Reflect since the last call. Each directory
+		/// gets unity_files files (fewer if it has fewer headers). Does nothing when unity_files isn't set.
+		/// </summary>
+		REFLECT_API void WriteUnityFiles(const ReflectAddtionalOptions& addtionalOptions);
+
+		/// <summary>
+		/// True if the files generated for 'headerPath' are all newer than it and the headers it includes
+		/// (HeaderCache::GetIncludedHeaders), so it doesn't need parsing again.
+		/// Always false with unity_files, the unity files need the code of every header.
+		/// </summary>
+		REFLECT_API static bool IsUpToDate(const std::string& headerPath, const std::vector<std::string>& includedHeaders, const ReflectAddtionalOptions& addtionalOptions);
+		/// <summary>
+		/// Write the depfile manifest (the depfile option) for 'headerPaths'. This is every header's .d file
+		/// joined together, so headers skipped by incremental keep the dependencies of the last run which parsed them.
+		/// </summary>
+		REFLECT_API static void WriteDependencyManifest(const std::vector<std::string>& headerPaths, const ReflectAddtionalOptions& addtionalOptions);
+
+		REFLECT_API static void IncludeHeader(const std::string& headerToInclude, CodeEmitter& file, bool windowsInclude = false);
+		REFLECT_API static size_t GetUnityFileCount(const ReflectAddtionalOptions& addtionalOptions);
+		/// <summary>
+		/// Path of a file generated for the header 'fileName' in 'directory'. 'extension' is ".h", ".cpp" or ".d".
+		/// </summary>
+		REFLECT_API static std::string GetGeneratedFilePath(const std::string& directory, const std::string& fileName, const char* extension);
+
+	private:
+		void WriteFile(const CodeEmitter& emitter, const std::string& filePath);
+		/// <summary>
+		/// Write the .d file listing what the generated files of 'data' depend on.
+		/// </summary>
+		void WriteDepfile(const FileParsedData& data, const ReflectAddtionalOptions& addtionalOptions);
+		void RemoveStaleUnityFiles(const std::string& generatedDirectory, size_t unityFileCount);
 
 	private:
-		std::ofstream OpenFile(const std::string& filePath);
-		void CloseFile(std::ofstream& file);
+		struct UnitySource
+		{
+			std::string FileName;
+			std::string Source;
+		};
+		std::mutex m_unityMutex;
+		// Generated .cpp code of each file, by the directory of the file.
+		std::unordered_map<std::string, std::vector<UnitySource>> m_unitySources;
 	};
-}
\ No newline at end of file
+}
@@ -3,7 +3,6 @@
 #include "Core/Core.h"
 #include "ReflectStructs.h"
 #include "CodeGenerate/CodeGenerate.h"
-#include<fstream>
 
 namespace Reflect
 {
@@ -13,17 +12,26 @@ namespace Reflect
 		CodeGenerateHeader() { }
 		~CodeGenerateHeader() { }
 
-		void GenerateHeader(const FileParsedData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions);
+		void GenerateHeader(const FileParsedData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
 
 		static std::string GetType(const Reflect::ReflectTypeNameData& arg, bool defaultReturnPointer);
+		static std::string GetReflectSuper(const ReflectContainerData& data);
+		/// <summary>
+		/// Size of the flattened member/function tables (own plus every resolved base).
+		/// </summary>
+		static size_t GetAllMemberCount(const ReflectContainerData& data);
+		static size_t GetAllFunctionCount(const ReflectContainerData& data);
 	private:
-		void WriteMacros(const FileParsedData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions);
-		void WriteMemberProperties(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
-		void WriteMemberPropertiesOffsets(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
-		void WriteMemberGet(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMacros(const FileParsedData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMemberProperties(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMemberPropertiesOffsets(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMemberGet(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
 
-		void WriteFunctions(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
-		void WriteFunctionGet(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteFunctions(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteFunctionGet(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteHash(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteTypeInfo(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteStaticClass(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions);
 
 	};
 }
@@ -12,15 +12,24 @@ namespace Reflect
 		CodeGenerateSource() { }
 		~CodeGenerateSource() { }
 
-		void GenerateSource(const FileParsedData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions);
+		void GenerateSource(const FileParsedData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
 
 	private:
 		
-		void WriteMemberProperties(const ReflectContainerData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMemberProperties(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteFunctionBodies(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteFunctionProperties(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		/// <summary>
+		/// Write the flattened member/function tables of a container with resolved bases.
+		/// </summary>
+		void WriteAllMemberProperties(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMemberProp(const ReflectMemberData& member, const std::string& offsetPrefix, CodeEmitter& file);
 
-		void WriteMemberGet(const ReflectContainerData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions);
-		void WriteFunctionGet(const ReflectContainerData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteMemberGet(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteFunctionGet(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteHash(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
+		void WriteTypeInfo(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions);
 
-		std::string MemberFormat();
+		const char* MemberFormat();
 	};
 }
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "Core/Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Reflect
+{
+	/// <summary>
+	/// Allocator interface used by the TypeInfo factory functions.
+	/// </summary>
+	class IAllocator
+	{
+	public:
+		using CleanupFunc = void(*)(void* data);
+
+		virtual ~IAllocator() { }
+
+		virtual void* Allocate(std::size_t size, std::size_t alignment) = 0;
+		virtual void Deallocate(void* ptr, std::size_t size, std::size_t alignment) = 0;
+
+		/// <summary>
+		/// Allocators which release everything in one go (ArenaAllocator) call 'func' with 'data' when they do.
+		/// Returns false if the allocator doesn't, the owner must call TypeInfo::Destroy.
+		/// </summary>
+		virtual bool AddCleanup(CleanupFunc func, void* data) { (void)func; (void)data; return false; }
+		/// <summary>
+		/// True if the allocator runs the cleanups added with AddCleanup itself. TypeInfo::Destroy then leaves
+		/// the object for the allocator, so its destructor isn't run twice.
+		/// </summary>
+		virtual bool OwnsObjectLifetimes() const { return false; }
+	};
+
+	/// <summary>
+	/// Default allocator. Uses the global (aligned) operator new/delete.
+	/// </summary>
+	class HeapAllocator : public IAllocator
+	{
+	public:
+		REFLECT_API static HeapAllocator& Get();
+
+		virtual void* Allocate(std::size_t size, std::size_t alignment) override
+		{
+			return ::operator new(size, std::align_val_t(alignment));
+		}
+
+		virtual void Deallocate(void* ptr, std::size_t size, std::size_t alignment) override
+		{
+			(void)size;
+			::operator delete(ptr, std::align_val_t(alignment));
+		}
+	};
+
+	/// <summary>
+	/// Fixed size block allocator. Blocks are carved out of large chunks and recycled through
+	/// a free list, so it is best used as a per type object pool. Not thread safe.
+	/// </summary>
+	class PoolAllocator : public IAllocator
+	{
+	public:
+		REFLECT_API PoolAllocator(std::size_t blockSize, std::size_t alignment, std::size_t blocksPerChunk = 256);
+		REFLECT_API virtual ~PoolAllocator() override;
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		/// <summary>
+		/// Returns nullptr if 'size'/'alignment' don't fit in a block.
+		/// </summary>
+		virtual void* Allocate(std::size_t size, std::size_t alignment) override
+		{
+			if (size > m_blockSize || alignment > m_alignment)
+			{
+				return nullptr;
+			}
+
+			if (m_freeList == nullptr)
+			{
+				AllocateChunk();
+			}
+			FreeBlock* block = m_freeList;
+			m_freeList = block->Next;
+			return block;
+		}
+
+		virtual void Deallocate(void* ptr, std::size_t size, std::size_t alignment) override
+		{
+			(void)size;
+			(void)alignment;
+			if (ptr)
+			{
+				FreeBlock* block = static_cast<FreeBlock*>(ptr);
+				block->Next = m_freeList;
+				m_freeList = block;
+			}
+		}
+
+		std::size_t GetBlockSize() const { return m_blockSize; }
+
+	private:
+		REFLECT_API void AllocateChunk();
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		std::size_t m_blockSize;
+		std::size_t m_alignment;
+		std::size_t m_blocksPerChunk;
+		FreeBlock* m_freeList;
+		std::vector<void*> m_chunks;
+	};
+
+	/// <summary>
+	/// Bump allocator for load-then-free-all workloads. Deallocate does nothing, all memory is released
+	/// in one go by Reset(). Registered cleanups (destructors) are run in reverse order on Reset(). Not thread safe.
+	/// </summary>
+	class ArenaAllocator : public IAllocator
+	{
+	public:
+		REFLECT_API ArenaAllocator(std::size_t blockSize = 64 * 1024);
+		REFLECT_API virtual ~ArenaAllocator() override;
+
+		ArenaAllocator(const ArenaAllocator&) = delete;
+		ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+		virtual void* Allocate(std::size_t size, std::size_t alignment) override
+		{
+			uintptr_t current = (reinterpret_cast<uintptr_t>(m_current) + (alignment - 1)) & ~(static_cast<uintptr_t>(alignment) - 1);
+			if (m_current == nullptr || current + size > reinterpret_cast<uintptr_t>(m_end))
+			{
+				return AllocateSlow(size, alignment);
+			}
+			m_current = reinterpret_cast<char*>(current + size);
+			return reinterpret_cast<void*>(current);
+		}
+
+		virtual void Deallocate(void* ptr, std::size_t size, std::size_t alignment) override
+		{
+			(void)ptr;
+			(void)size;
+			(void)alignment;
+		}
+
+		/// <summary>
+		/// Call 'func' with 'data' when the arena is reset/destroyed.
+		/// </summary>
+		REFLECT_API virtual bool AddCleanup(CleanupFunc func, void* data) override;
+		virtual bool OwnsObjectLifetimes() const override { return true; }
+
+		/// <summary>
+		/// Run all the cleanups and release every allocation. The first block is kept for reuse.
+		/// </summary>
+		REFLECT_API void Reset();
+
+		std::size_t GetBytesReserved() const { return m_bytesReserved; }
+
+	private:
+		REFLECT_API void* AllocateSlow(std::size_t size, std::size_t alignment);
+
+	private:
+		struct Cleanup
+		{
+			CleanupFunc Func;
+			void* Data;
+			Cleanup* Next;
+		};
+
+		struct Block
+		{
+			char* Memory;
+			std::size_t Size;
+		};
+
+		std::size_t m_blockSize;
+		std::size_t m_bytesReserved;
+		char* m_current;
+		char* m_end;
+		Cleanup* m_cleanups;
+		std::vector<Block> m_blocks;
+	};
+
+	/// <summary>
+	/// Standard library allocator which allocates from an ArenaAllocator, or the heap without one. A container copied
+	/// from one gets the heap, so the copy doesn't depend on (or allocate from) the arena of the original.
+	/// Example: std::vector<int, ArenaStdAllocator<int>> values(ArenaStdAllocator<int>(&arena));
+	/// </summary>
+	template<typename T>
+	class ArenaStdAllocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
+
+		ArenaStdAllocator() = default;
+		ArenaStdAllocator(ArenaAllocator* arena) : m_arena(arena) { }
+		template<typename U>
+		ArenaStdAllocator(const ArenaStdAllocator<U>& other) : m_arena(other.GetArena()) { }
+
+		T* allocate(std::size_t count)
+		{
+			if (m_arena)
+			{
+				return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+			}
+			return std::allocator<T>().allocate(count);
+		}
+
+		void deallocate(T* ptr, std::size_t count)
+		{
+			if (!m_arena)
+			{
+				std::allocator<T>().deallocate(ptr, count);
+			}
+		}
+
+		ArenaStdAllocator select_on_container_copy_construction() const { return ArenaStdAllocator(); }
+
+		ArenaAllocator* GetArena() const { return m_arena; }
+
+		template<typename U>
+		bool operator==(const ArenaStdAllocator<U>& other) const { return m_arena == other.GetArena(); }
+		template<typename U>
+		bool operator!=(const ArenaStdAllocator<U>& other) const { return m_arena != other.GetArena(); }
+
+	private:
+		ArenaAllocator* m_arena = nullptr;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Log.h"
+#include "ReflectFwd.h"
 #include <unordered_map>
 
 #if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
@@ -13,23 +14,6 @@
 #pragma error C++17 must be used.
 #endif
 
-#ifdef REFLECT_DLL_EXPORT
-#define REFLECT_API __declspec(dllexport)
-#elif defined (REFLECT_DLL_IMPORT)
-#define REFLECT_API __declspec(dllimport)
-#else 
-#define REFLECT_API
-#endif
-
-#define REFLECT_PROPERTY(...)
-#define NO_REFLECT(x) x
-
-#define BODY_MACRO_COMBINE_INNER(A, B, C, D) A##B##C##D
-#define BODY_MACRO_COMBINE(A, B, C, D) BODY_MACRO_COMBINE_INNER(A, B, C, D)
-
-#define REFLECT_GENERATED_BODY(...) BODY_MACRO_COMBINE(CURRENT_FILE_ID, _, __LINE__, _GENERATED_BODY);
-#define REFLECT_CPP_INCLUDE(...)
-
 namespace Reflect
 {
 	#define REFLECT_MAJOR 3
@@ -43,12 +27,51 @@ namespace Reflect
 	constexpr const char* ReflectCPPIncludeKey = "REFLECT_CPP_INCLUDE";
 	constexpr const char* ReflectFileGeneratePrefix = "_reflect_generated";
 	constexpr const char* ReflectIgnoreStringsFileName = "reflect_ignore_strings.txt";
+	// Name of the amalgamated .cpp files written when unity_files is set ("ReflectUnity_0_reflect_generated.cpp", ...).
+	constexpr const char* ReflectUnityFilePrefix = "ReflectUnity_";
+
+	// Container flags (REFLECT_STRUCT(...)/REFLECT_CLASS(...)) which change the generated code.
+	constexpr const char* ReflectContainerFlagHashable = "Hashable";
 
 	constexpr const char* Reflect_CMD_Option_PCH_Include = "pchInclude";
 	constexpr const char* Reflect_CMD_Option_Reflect_Full_EXT = "reflect_full_ext";
+	// Comma separated list of profile categories to record. Empty records all of them.
+	constexpr const char* Reflect_CMD_Option_Profile_Categories = "profile_categories";
+	// Write the end of run report as json to this path.
+	constexpr const char* Reflect_CMD_Option_Report_Json = "report_json";
+	// Number of files listed in the slowest files part of the report.
+	constexpr const char* Reflect_CMD_Option_Report_Slowest = "report_slowest";
+	// Warn about any file or class/struct which takes longer than this many milliseconds to parse. 0 disables the warnings.
+	constexpr const char* Reflect_CMD_Option_Parse_Warn_Ms = "parse_warn_ms";
+	// Verbosity of the log (error, warn, info or verbose).
+	constexpr const char* Reflect_CMD_Option_Log_Level = "log_level";
+	// Only log errors and skip the end of run report.
+	constexpr const char* Reflect_CMD_Option_Quiet = "quiet";
+	// Parse, generate and write each file on a pool of worker threads as soon as it is found.
+	constexpr const char* Reflect_CMD_Option_Parallel = "parallel";
+	// Number of worker threads used when parallel is true. 0 uses one per hardware thread.
+	constexpr const char* Reflect_CMD_Option_Threads = "threads";
+	// Put the generated .cpp code of each directory into this many amalgamated (unity) .cpp files instead of one per header. 0 disables it.
+	constexpr const char* Reflect_CMD_Option_Unity_Files = "unity_files";
+	// Write a Makefile/Ninja style dependency manifest for every input header to this path.
+	constexpr const char* Reflect_CMD_Option_Depfile = "depfile";
+	// Skip headers whose generated files are newer than the header.
+	constexpr const char* Reflect_CMD_Option_Incremental = "incremental";
+	// File with the headers to parse, one per line ("-" for stdin). Used as well as any directories passed.
+	constexpr const char* Reflect_CMD_Option_File_List = "file_list";
+	// Only parse the headers in shard shard_index of shard_count, so the work can be split across build machines.
+	constexpr const char* Reflect_CMD_Option_Shard_Index = "shard_index";
+	constexpr const char* Reflect_CMD_Option_Shard_Count = "shard_count";
+	// Write the parsed model of every header to this reflection database (see ReflectDatabase).
+	constexpr const char* Reflect_CMD_Option_Database = "database";
 	constexpr const char* Reflect_CMD_Options[] =
 	{
-		Reflect_CMD_Option_PCH_Include, Reflect_CMD_Option_Reflect_Full_EXT
+		Reflect_CMD_Option_PCH_Include, Reflect_CMD_Option_Reflect_Full_EXT, Reflect_CMD_Option_Profile_Categories,
+		Reflect_CMD_Option_Report_Json, Reflect_CMD_Option_Report_Slowest, Reflect_CMD_Option_Parse_Warn_Ms,
+		Reflect_CMD_Option_Log_Level, Reflect_CMD_Option_Quiet, Reflect_CMD_Option_Parallel, Reflect_CMD_Option_Threads,
+		Reflect_CMD_Option_Unity_Files, Reflect_CMD_Option_Depfile, Reflect_CMD_Option_Incremental,
+		Reflect_CMD_Option_File_List, Reflect_CMD_Option_Shard_Index, Reflect_CMD_Option_Shard_Count,
+		Reflect_CMD_Option_Database
 	};
 
 	struct ReflectAddtionalOptions
@@ -57,6 +80,21 @@ namespace Reflect
 		{
 			{ Reflect::Reflect_CMD_Option_PCH_Include, "" },
 			{ Reflect::Reflect_CMD_Option_Reflect_Full_EXT, "false" },
+			{ Reflect::Reflect_CMD_Option_Profile_Categories, "" },
+			{ Reflect::Reflect_CMD_Option_Report_Json, "" },
+			{ Reflect::Reflect_CMD_Option_Report_Slowest, "10" },
+			{ Reflect::Reflect_CMD_Option_Parse_Warn_Ms, "0" },
+			{ Reflect::Reflect_CMD_Option_Log_Level, "info" },
+			{ Reflect::Reflect_CMD_Option_Quiet, "false" },
+			{ Reflect::Reflect_CMD_Option_Parallel, "false" },
+			{ Reflect::Reflect_CMD_Option_Threads, "0" },
+			{ Reflect::Reflect_CMD_Option_Unity_Files, "0" },
+			{ Reflect::Reflect_CMD_Option_Depfile, "" },
+			{ Reflect::Reflect_CMD_Option_Incremental, "false" },
+			{ Reflect::Reflect_CMD_Option_File_List, "" },
+			{ Reflect::Reflect_CMD_Option_Shard_Index, "0" },
+			{ Reflect::Reflect_CMD_Option_Shard_Count, "1" },
+			{ Reflect::Reflect_CMD_Option_Database, "" },
 
 		};
 	};
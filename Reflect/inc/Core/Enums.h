@@ -26,6 +26,18 @@ namespace Reflect
 		Unknown
 	};
 
+	/// <summary>
+	/// How a container inherits one of its bases.
+	/// </summary>
+	enum class EReflectAccess
+	{
+		Public,
+		Protected,
+		Private,
+	};
+	REFLECT_API const char* ReflectAccessToString(EReflectAccess access);
+	REFLECT_API EReflectAccess StringToReflectAccess(const std::string& str);
+
 	enum class EReflectValueType
 	{
 		Value,
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "ReflectFwd.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+namespace Reflect
+{
+	namespace Hash
+	{
+		constexpr uint64_t DefaultSeed = 0x9E3779B97F4A7C15ull;
+
+		/// <summary>
+		/// Scramble the bits of a 64 bit value (murmur3 finaliser).
+		/// </summary>
+		constexpr uint64_t Mix(uint64_t value)
+		{
+			value ^= value >> 33;
+			value *= 0xFF51AFD7ED558CCDull;
+			value ^= value >> 33;
+			value *= 0xC4CEB9FE1A85EC53ull;
+			value ^= value >> 33;
+			return value;
+		}
+
+		constexpr uint64_t Combine(uint64_t seed, uint64_t value)
+		{
+			return Mix(seed ^ (value + DefaultSeed + (seed << 6) + (seed >> 2)));
+		}
+
+		/// <summary>
+		/// Fast non-cryptographic hash over a block of memory. Consumes 8 bytes at a time.
+		/// </summary>
+		inline uint64_t HashBytes(const void* data, std::size_t size, uint64_t seed = DefaultSeed)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			uint64_t hash = seed ^ (static_cast<uint64_t>(size) * 0x87C37B91114253D5ull);
+
+			while (size >= sizeof(uint64_t))
+			{
+				uint64_t chunk;
+				memcpy(&chunk, bytes, sizeof(uint64_t));
+				hash = Mix(hash ^ chunk) * 0x4CF5AD432745937Full;
+				bytes += sizeof(uint64_t);
+				size -= sizeof(uint64_t);
+			}
+
+			uint64_t tail = 0;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				tail |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+			}
+			return Mix(hash ^ tail);
+		}
+
+		template<typename T, typename = void>
+		struct HasHashMember : std::false_type { };
+		template<typename T>
+		struct HasHashMember<T, std::void_t<decltype(std::declval<const T&>().Hash())>> : std::true_type { };
+
+		template<typename T, typename = void>
+		struct HasEqualsMember : std::false_type { };
+		template<typename T>
+		struct HasEqualsMember<T, std::void_t<decltype(std::declval<const T&>().Equals(std::declval<const T&>()))>> : std::true_type { };
+
+		template<typename T, typename = void>
+		struct HasStdHash : std::false_type { };
+		template<typename T>
+		struct HasStdHash<T, std::enable_if_t<std::is_default_constructible_v<std::hash<T>>>> : std::true_type { };
+
+		template<typename T, typename = void>
+		struct HasEqualOperator : std::false_type { };
+		template<typename T>
+		struct HasEqualOperator<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>> : std::true_type { };
+
+		template<typename T, typename = void>
+		struct IsRange : std::false_type { };
+		template<typename T>
+		struct IsRange<T, std::void_t<decltype(std::begin(std::declval<const T&>())), decltype(std::end(std::declval<const T&>()))>> : std::true_type { };
+
+		// unordered_map/unordered_set, the order of the elements doesn't say anything about equality.
+		template<typename T, typename = void>
+		struct IsUnorderedRange : std::false_type { };
+		template<typename T>
+		struct IsUnorderedRange<T, std::void_t<typename T::hasher>> : IsRange<T> { };
+
+		template<typename T>
+		struct IsPair : std::false_type { };
+		template<typename First, typename Second>
+		struct IsPair<std::pair<First, Second>> : std::true_type { };
+
+		template<typename T>
+		struct DependentFalse : std::false_type { };
+
+		/// <summary>
+		/// Hash a single value. Prefers a generated Hash(), then the raw bytes for types
+		/// with a unique object representation, then std::hash. Containers (std::vector, std::map, ...)
+		/// and std::pair are hashed element by element.
+		/// </summary>
+		template<typename T>
+		uint64_t HashValue(const T& value)
+		{
+			if constexpr (HasHashMember<T>::value)
+			{
+				return static_cast<uint64_t>(value.Hash());
+			}
+			else if constexpr (std::has_unique_object_representations_v<T>)
+			{
+				return HashBytes(&value, sizeof(T));
+			}
+			else if constexpr (HasStdHash<T>::value)
+			{
+				return static_cast<uint64_t>(std::hash<T>{}(value));
+			}
+			else if constexpr (IsPair<T>::value)
+			{
+				return Combine(HashValue(value.first), HashValue(value.second));
+			}
+			else if constexpr (IsUnorderedRange<T>::value)
+			{
+				// Summed so equal containers hash the same whatever order their elements are in.
+				uint64_t hash = 0;
+				uint64_t count = 0;
+				for (const auto& element : value)
+				{
+					hash += Mix(HashValue(element));
+					++count;
+				}
+				return Combine(hash, count);
+			}
+			else if constexpr (IsRange<T>::value)
+			{
+				uint64_t hash = DefaultSeed;
+				for (const auto& element : value)
+				{
+					hash = Combine(hash, HashValue(element));
+				}
+				return hash;
+			}
+			else
+			{
+				static_assert(DependentFalse<T>::value, "[Reflect::Hash::HashValue] Member type can't be hashed. "
+					"Reflect it with REFLECT_STRUCT(Hashable), specialise std::hash for it or make it a container of hashable types.");
+				return 0;
+			}
+		}
+
+		template<typename T>
+		bool Equal(const T& lhs, const T& rhs)
+		{
+			if constexpr (HasEqualsMember<T>::value)
+			{
+				return lhs.Equals(rhs);
+			}
+			else if constexpr (std::has_unique_object_representations_v<T>)
+			{
+				return memcmp(&lhs, &rhs, sizeof(T)) == 0;
+			}
+			else if constexpr (IsPair<T>::value)
+			{
+				return Equal(lhs.first, rhs.first) && Equal(lhs.second, rhs.second);
+			}
+			else if constexpr (IsRange<T>::value && !IsUnorderedRange<T>::value && !HasStdHash<T>::value)
+			{
+				// Element by element so elements which only have a generated Equals() work too.
+				auto lhsItr = std::begin(lhs);
+				auto rhsItr = std::begin(rhs);
+				for (; lhsItr != std::end(lhs) && rhsItr != std::end(rhs); ++lhsItr, ++rhsItr)
+				{
+					if (!Equal(*lhsItr, *rhsItr))
+					{
+						return false;
+					}
+				}
+				return lhsItr == std::end(lhs) && rhsItr == std::end(rhs);
+			}
+			else if constexpr (HasEqualOperator<T>::value)
+			{
+				return lhs == rhs;
+			}
+			else
+			{
+				static_assert(DependentFalse<T>::value, "[Reflect::Hash::Equal] Member type can't be compared. "
+					"Reflect it with REFLECT_STRUCT(Hashable), give it an operator== or make it a container of comparable types.");
+				return false;
+			}
+		}
+
+		/// <summary>
+		/// True if the members between [begin, end) can be hashed/compared as one block of bytes.
+		/// Every type must have a unique object representation and there must be no padding.
+		/// </summary>
+		template<typename... Types>
+		constexpr bool IsTrivialSpan(std::size_t begin, std::size_t end)
+		{
+			return (std::has_unique_object_representations_v<Types> && ...) &&
+				end - begin == (sizeof(Types) + ...);
+		}
+
+		/// <summary>
+		/// Functors for using generated Hash()/Equals() with std containers.
+		/// Example: std::unordered_map<Key, Value, Reflect::Hash::Hasher<Key>, Reflect::Hash::EqualTo<Key>>
+		/// </summary>
+		template<typename T>
+		struct Hasher
+		{
+			std::size_t operator()(const T& value) const { return value.Hash(); }
+		};
+
+		template<typename T>
+		struct EqualTo
+		{
+			bool operator()(const T& lhs, const T& rhs) const { return lhs.Equals(rhs); }
+		};
+	}
+}
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "ReflectFwd.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #ifdef _WIN32
 #define NOMINMAX
@@ -37,18 +44,178 @@ namespace Reflect
 			Light_White,
 		};
 
-		static void Message(ConsoleColour textColour, ConsoleColour backgroundColour, const char* fmt, ...)
+		/// <summary>
+		/// Verbosity of a message. Only messages at or below the logger's level are written.
+		/// </summary>
+		enum class LogLevel : uint8_t
 		{
-			va_list args = {};
-			int length = 0;
-			char* buffer = nullptr;
+			Error,
+			Warn,
+			Info,
+			Verbose,
+		};
 
-			va_start(args, fmt);
-			length = _vscprintf(fmt, args) + 1;
-			buffer = (char*)malloc(length * sizeof(char));
-			if (buffer != nullptr)
+		inline const char* LogLevelToString(LogLevel level)
+		{
+			switch (level)
+			{
+			case LogLevel::Error:	return "error";
+			case LogLevel::Warn:	return "warn";
+			case LogLevel::Info:	return "info";
+			case LogLevel::Verbose:	return "verbose";
+			}
+			return "info";
+		}
+
+		/// <summary>
+		/// Parse a level name as written by LogLevelToString. Returns 'defaultLevel' if the name is unknown.
+		/// </summary>
+		inline LogLevel LogLevelFromString(const std::string& name, LogLevel defaultLevel = LogLevel::Info)
+		{
+			for (LogLevel level : { LogLevel::Error, LogLevel::Warn, LogLevel::Info, LogLevel::Verbose })
+			{
+				if (name == LogLevelToString(level))
+				{
+					return level;
+				}
+			}
+			return defaultLevel;
+		}
+
+		/// <summary>
+		/// Writes log messages on a background thread so logging never blocks the parser or generator.
+		/// Messages are pushed onto an intrusive lock free queue (multiple producers, drained by the writer
+		/// thread) and the console is only flushed once the queue is empty, not after every message.
+		/// The writer thread is started on the first message. Call Flush() before writing to std::cout
+		/// directly so the output stays in order. Call Shutdown() before the program exits to write what is left
+		/// and join the writer thread. It isn't joined by a static destructor, in ReflectDLL that would run under
+		/// the loader lock. There is one logger for the process, the instance is defined in Log.cpp.
+		/// </summary>
+		class AsyncLogger
+		{
+			struct LogEntry
+			{
+				ConsoleColour TextColour;
+				ConsoleColour BackgroundColour;
+				std::string Message;
+				std::atomic<LogEntry*> Next;
+			};
+
+		public:
+			REFLECT_API static AsyncLogger& Get();
+
+			AsyncLogger(const AsyncLogger&) = delete;
+			AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+			void SetLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+			LogLevel GetLevel() const { return m_level.load(std::memory_order_relaxed); }
+
+			/// <summary>
+			/// Quiet mode only writes errors, whatever the level is set to.
+			/// </summary>
+			void SetQuiet(bool quiet) { m_quiet.store(quiet, std::memory_order_relaxed); }
+			bool IsQuiet() const { return m_quiet.load(std::memory_order_relaxed); }
+
+			/// <summary>
+			/// When async is false messages are written on the calling thread before Push returns.
+			/// </summary>
+			void SetAsync(bool async)
+			{
+				if (!async)
+				{
+					Flush();
+				}
+				m_async.store(async, std::memory_order_relaxed);
+			}
+			bool IsAsync() const { return m_async.load(std::memory_order_relaxed); }
+
+			bool ShouldLog(LogLevel level) const
+			{
+				return level <= (IsQuiet() ? LogLevel::Error : GetLevel());
+			}
+
+			void Push(ConsoleColour textColour, ConsoleColour backgroundColour, std::string message)
+			{
+				if (!IsAsync())
+				{
+					std::lock_guard lock(m_writeMutex);
+					Write(textColour, backgroundColour, message);
+					std::cout.flush();
+					return;
+				}
+
+				LogEntry* entry = new LogEntry{ textColour, backgroundColour, std::move(message), { nullptr } };
+				LogEntry* previous = m_head.exchange(entry, std::memory_order_acq_rel);
+				previous->Next.store(entry, std::memory_order_release);
+
+				std::call_once(m_startWriter, [this]()
+					{
+						m_writerThread = std::thread(&AsyncLogger::WriterThread, this);
+					});
+				m_condition.notify_one();
+			}
+
+			/// <summary>
+			/// Write every message pushed so far on the calling thread.
+			/// </summary>
+			void Flush()
+			{
+				DrainQueue();
+				std::lock_guard lock(m_writeMutex);
+				std::cout.flush();
+			}
+
+			/// <summary>
+			/// Write every message pushed so far and join the writer thread. Messages after this are written
+			/// on the calling thread.
+			/// </summary>
+			REFLECT_API void Shutdown();
+
+		private:
+			AsyncLogger()
+			{
+				// The queue always holds one already written entry which the consumer owns.
+				m_tail = new LogEntry{ ConsoleColour::Light_White, ConsoleColour::Black, std::string(), { nullptr } };
+				m_head.store(m_tail, std::memory_order_relaxed);
+			}
+
+			void WriterThread()
+			{
+				while (true)
+				{
+					DrainQueue();
+					{
+						std::lock_guard lock(m_writeMutex);
+						std::cout.flush();
+					}
+
+					std::unique_lock lock(m_mutex);
+					if (m_stop)
+					{
+						break;
+					}
+					// Producers notify without taking the lock, the timeout picks up a missed notify.
+					m_condition.wait_for(lock, std::chrono::milliseconds(10));
+				}
+			}
+
+			// The queue only supports a single consumer at a time, m_writeMutex is held for the whole drain.
+			void DrainQueue()
+			{
+				std::lock_guard lock(m_writeMutex);
+				LogEntry* next = m_tail->Next.load(std::memory_order_acquire);
+				while (next != nullptr)
+				{
+					Write(next->TextColour, next->BackgroundColour, next->Message);
+					next->Message = std::string();
+					delete m_tail;
+					m_tail = next;
+					next = m_tail->Next.load(std::memory_order_acquire);
+				}
+			}
+
+			static void Write(ConsoleColour textColour, ConsoleColour backgroundColour, const std::string& message)
 			{
-				vsprintf_s(buffer, length, fmt, args);
 #ifdef _WIN32
 				HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 				if (hConsole)
@@ -56,24 +223,71 @@ namespace Reflect
 					uint32_t attri = (uint32_t)textColour + ((uint32_t)backgroundColour * 16);
 					SetConsoleTextAttribute(hConsole, attri);
 				}
-				OutputDebugStringA(buffer);
+				OutputDebugStringA(message.c_str());
 #endif
-				std::cout << buffer << '\n';
+				std::cout << message << '\n';
 
 #ifdef _WIN32
 				if (hConsole)
 				{
+					// The colour is applied to whatever is in the console buffer, so flush before resetting it.
+					std::cout.flush();
 					uint32_t attri = (uint32_t)ConsoleColour::Light_White + ((uint32_t)ConsoleColour::Black * 16);
 					SetConsoleTextAttribute(hConsole, attri);
 				}
 #endif
-				free(buffer);
+			}
+
+		private:
+			std::atomic<LogEntry*> m_head;
+			LogEntry* m_tail;
+
+			std::atomic<LogLevel> m_level = LogLevel::Info;
+			std::atomic<bool> m_quiet = false;
+			std::atomic<bool> m_async = true;
+
+			std::once_flag m_startWriter;
+			std::thread m_writerThread;
+			std::mutex m_mutex;
+			std::condition_variable m_condition;
+			bool m_stop = false;
+			// Owns the consumer end of the queue and the console, so drains and synchronous writes don't interleave.
+			std::mutex m_writeMutex;
+		};
+
+		inline void SetLevel(LogLevel level) { AsyncLogger::Get().SetLevel(level); }
+		inline void SetQuiet(bool quiet) { AsyncLogger::Get().SetQuiet(quiet); }
+		inline void SetAsync(bool async) { AsyncLogger::Get().SetAsync(async); }
+		inline void Flush() { AsyncLogger::Get().Flush(); }
+		inline void Shutdown() { AsyncLogger::Get().Shutdown(); }
+
+		inline void Message(LogLevel level, ConsoleColour textColour, ConsoleColour backgroundColour, const char* fmt, ...)
+		{
+			AsyncLogger& logger = AsyncLogger::Get();
+			if (!logger.ShouldLog(level))
+			{
+				return;
+			}
+
+			va_list args = {};
+			va_list argsCopy = {};
+			va_start(args, fmt);
+			va_copy(argsCopy, args);
+			int length = _vscprintf(fmt, argsCopy);
+			va_end(argsCopy);
+			if (length >= 0)
+			{
+				std::string message;
+				message.resize(static_cast<size_t>(length));
+				vsprintf_s(message.data(), length + 1, fmt, args);
+				logger.Push(textColour, backgroundColour, std::move(message));
 			}
 			va_end(args);
 		}
 	}
 }
 
-#define Log_Info(fmt, ...) Reflect::Log::Message(Reflect::Log::ConsoleColour::Light_White, Reflect::Log::ConsoleColour::Black, fmt, __VA_ARGS__);
-#define Log_Warn(fmt, ...) Reflect::Log::Message(Reflect::Log::ConsoleColour::Light_Yellow, Reflect::Log::ConsoleColour::Black, fmt, __VA_ARGS__);
-#define Log_Error(fmt, ...) Reflect::Log::Message(Reflect::Log::ConsoleColour::Light_Red, Reflect::Log::ConsoleColour::Black, fmt, __VA_ARGS__);
\ No newline at end of file
+#define Log_Verbose(...) Reflect::Log::Message(Reflect::Log::LogLevel::Verbose, Reflect::Log::ConsoleColour::Draw_Grey, Reflect::Log::ConsoleColour::Black, __VA_ARGS__);
+#define Log_Info(...) Reflect::Log::Message(Reflect::Log::LogLevel::Info, Reflect::Log::ConsoleColour::Light_White, Reflect::Log::ConsoleColour::Black, __VA_ARGS__);
+#define Log_Warn(...) Reflect::Log::Message(Reflect::Log::LogLevel::Warn, Reflect::Log::ConsoleColour::Light_Yellow, Reflect::Log::ConsoleColour::Black, __VA_ARGS__);
+#define Log_Error(...) Reflect::Log::Message(Reflect::Log::LogLevel::Error, Reflect::Log::ConsoleColour::Light_Red, Reflect::Log::ConsoleColour::Black, __VA_ARGS__);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Core/TypeRegistry.h"
+#include "ReflectStructs.h"
+#include <string.h>
+#include <type_traits>
+
+namespace Reflect
+{
+	template<typename T, typename = void>
+	struct IsReflectedType : std::false_type { };
+	template<typename T>
+	struct IsReflectedType<T, std::void_t<decltype(T::StaticTypeInfo()), typename T::__REFLECT_SUPER__>> : std::true_type { };
+
+	/// <summary>
+	/// Non virtual version of the IReflect API for callers which know the concrete type.
+	/// Walks the generated TypeInfo tables directly and recurses into the reflected base type
+	/// at compile time, so nothing goes through the vtable. Only a public base is recursed into, the members of
+	/// private/protected bases aren't visible from outside the type.
+	/// Example: Reflect::ReflectStatic<Player>::GetMember(player, "Friends");
+	/// </summary>
+	template<typename T>
+	struct ReflectStatic
+	{
+		static_assert(IsReflectedType<T>::value, "[ReflectStatic] T must have a REFLECT_GENERATED_BODY().");
+
+		using Super = typename T::__REFLECT_SUPER__;
+		static constexpr bool HasReflectedSuper = IsReflectedType<Super>::value;
+
+		static ReflectFunction GetFunction(T& object, const char* functionName)
+		{
+			for (const auto& func : T::StaticTypeInfo().GetFunctions())
+			{
+				if (strcmp(functionName, func.Name) == 0)
+				{
+					return ReflectFunction(static_cast<void*>(&object), func.Func);
+				}
+			}
+			if constexpr (HasReflectedSuper)
+			{
+				return ReflectStatic<Super>::GetFunction(static_cast<Super&>(object), functionName);
+			}
+			else
+			{
+				return ReflectFunction(nullptr, nullptr);
+			}
+		}
+
+		static ReflectMember GetMember(T& object, const char* memberName)
+		{
+			for (auto& member : T::StaticTypeInfo().GetMembers())
+			{
+				if (strcmp(memberName, member.Name) == 0)
+				{
+					return MakeMember(object, member);
+				}
+			}
+			if constexpr (HasReflectedSuper)
+			{
+				return ReflectStatic<Super>::GetMember(static_cast<Super&>(object), memberName);
+			}
+			else
+			{
+				return ReflectMember("", nullptr, nullptr);
+			}
+		}
+
+		static std::vector<ReflectMember> GetMembers(T& object, std::vector<std::string> const& flags)
+		{
+			std::vector<ReflectMember> members;
+			AppendMembers(object, members, &flags);
+			return members;
+		}
+
+		static std::vector<ReflectMember> GetAllMembers(T& object)
+		{
+			std::vector<ReflectMember> members;
+			AppendMembers(object, members, nullptr);
+			return members;
+		}
+
+		/// <summary>
+		/// Append the members (base members first) to 'members'. If 'flags' is not null only members
+		/// with one of the flags are added.
+		/// </summary>
+		static void AppendMembers(T& object, std::vector<ReflectMember>& members, std::vector<std::string> const* flags)
+		{
+			if (T::StaticTypeInfo().HasResolvedBases())
+			{
+				// The flattened table already has the base members, with offsets from the start of T.
+				for (auto& member : T::StaticTypeInfo().GetAllMembers())
+				{
+					if (flags == nullptr || member.ContainsProperty(*flags))
+					{
+						members.push_back(MakeMember(object, member));
+					}
+				}
+				return;
+			}
+			if constexpr (HasReflectedSuper)
+			{
+				ReflectStatic<Super>::AppendMembers(static_cast<Super&>(object), members, flags);
+			}
+			for (auto& member : T::StaticTypeInfo().GetMembers())
+			{
+				if (flags == nullptr || member.ContainsProperty(*flags))
+				{
+					members.push_back(MakeMember(object, member));
+				}
+			}
+		}
+
+	private:
+		static ReflectMember MakeMember(T& object, ReflectMemberProp& member)
+		{
+			return ReflectMember(member.Name, member.Type, reinterpret_cast<char*>(&object) + member.Offset);
+		}
+	};
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Core/Core.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <stdint.h>
+
+namespace Reflect
+{
+	enum class EReflectPhase : uint8_t
+	{
+		DirectoryWalk,
+		Load,
+		Parse,
+		CodeGenerate,
+		Write,
+
+		Count
+	};
+
+	REFLECT_API const char* ReflectPhaseToString(EReflectPhase phase);
+
+	/// <summary>
+	/// Per thread count of heap allocations. Only counts when built with REFLECT_TRACK_ALLOCATIONS (premake
+	/// --track-allocations), which replaces the global operator new of the module Core/AllocationCounter.cpp is
+	/// linked into. Otherwise it stays at 0. With ReflectDLL only the allocations made inside the DLL are counted.
+	/// </summary>
+	struct AllocationCounter
+	{
+		REFLECT_API static uint64_t Get();
+		REFLECT_API static void RecordAllocation();
+		REFLECT_API static bool IsEnabled();
+	};
+
+	struct FileStats
+	{
+		// Directory and name of the source file, without the extension (FileParsedData::FilePath + "/" + FileName).
+		std::string File;
+		size_t Bytes = 0;
+		uint64_t ParseAllocations = 0;
+		int64_t PhaseTime[static_cast<size_t>(EReflectPhase::Count)] = { };
+
+		int64_t GetTotalTime() const
+		{
+			int64_t total = 0;
+			for (int64_t time : PhaseTime)
+			{
+				total += time;
+			}
+			return total;
+		}
+	};
+
+	/// <summary>
+	/// Cost of parsing a single reflected class/struct.
+	/// </summary>
+	struct ContainerStats
+	{
+		std::string File;
+		std::string Container;
+		int64_t ParseTime = 0;
+		size_t BytesScanned = 0;
+		uint64_t Allocations = 0;
+	};
+
+	/// <summary>
+	/// Time (in nanoseconds) spent in each phase of a run, with a breakdown per file. Filled in by the
+	/// FileParser and CodeGenerate, used by ReflectEXE for the end of run report.
+	/// </summary>
+	class RunStats
+	{
+	public:
+		REFLECT_API static RunStats& Get();
+
+		REFLECT_API void Reset();
+
+		/// <summary>
+		/// Add time which doesn't belong to a single file (e.g. walking the directories).
+		/// </summary>
+		REFLECT_API void AddPhaseTime(EReflectPhase phase, int64_t nanoseconds);
+		/// <summary>
+		/// Add time spent on 'file'. 'bytes' is the size of the source file, pass it once from the load phase.
+		/// </summary>
+		REFLECT_API void AddFileTime(const std::string& file, EReflectPhase phase, int64_t nanoseconds, size_t bytes = 0);
+		REFLECT_API void AddFileParseAllocations(const std::string& file, uint64_t allocations);
+		REFLECT_API void AddContainer(ContainerStats container);
+
+		REFLECT_API int64_t GetPhaseTime(EReflectPhase phase) const;
+		REFLECT_API size_t GetFileCount() const;
+		REFLECT_API size_t GetTotalBytes() const;
+		REFLECT_API std::vector<FileStats> GetSlowestFiles(size_t count) const;
+		REFLECT_API std::vector<ContainerStats> GetSlowestContainers(size_t count) const;
+
+		/// <summary>
+		/// Peak resident set size of the process in bytes, 0 if it can't be queried on this platform.
+		/// </summary>
+		REFLECT_API static size_t GetPeakRSS();
+
+		/// <summary>
+		/// Human readable report. 'wallTime' is the total time of the run in nanoseconds.
+		/// </summary>
+		REFLECT_API std::string ToString(int64_t wallTime, size_t slowestCount) const;
+		REFLECT_API std::string ToJson(int64_t wallTime, size_t slowestCount) const;
+
+		static int64_t Now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+	private:
+		RunStats() { }
+
+		// Note: you must already own lock on m_mutex before calling FindOrAddFile().
+		FileStats& FindOrAddFile(const std::string& file);
+
+	private:
+		mutable std::mutex m_mutex;
+		int64_t m_phaseTime[static_cast<size_t>(EReflectPhase::Count)] = { };
+		std::vector<FileStats> m_files;
+		std::unordered_map<std::string, size_t> m_fileIndex;
+		std::vector<ContainerStats> m_containers;
+	};
+
+	/// <summary>
+	/// Add the lifetime of this object to a phase in RunStats::Get().
+	/// </summary>
+	class ScopedPhaseTimer
+	{
+	public:
+		ScopedPhaseTimer(EReflectPhase phase, const std::string& file)
+			: m_phase(phase), m_file(file), m_start(RunStats::Now())
+		{ }
+		~ScopedPhaseTimer()
+		{
+			RunStats::Get().AddFileTime(m_file, m_phase, RunStats::Now() - m_start);
+		}
+
+		ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+		ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+	private:
+		EReflectPhase m_phase;
+		const std::string& m_file;
+		int64_t m_start;
+	};
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Reflect
+{
+	template<typename T>
+	struct MemberPointerTraits;
+
+	template<typename Class, typename Type>
+	struct MemberPointerTraits<Type Class::*>
+	{
+		using class_type = Class;
+		using value_type = Type;
+	};
+
+	/// <summary>
+	/// Compile time description of a single reflected member. The member pointer and type are
+	/// template parameters so code iterating over the members can be fully inlined.
+	/// </summary>
+	template<auto MemberPtr, std::size_t FlagCount>
+	struct StaticMember
+	{
+		using class_type = typename MemberPointerTraits<decltype(MemberPtr)>::class_type;
+		using value_type = typename MemberPointerTraits<decltype(MemberPtr)>::value_type;
+		static constexpr auto Pointer = MemberPtr;
+
+		std::string_view Name;
+		std::size_t Offset;
+		std::array<std::string_view, FlagCount> Flags;
+
+		constexpr bool ContainsProperty(std::string_view flag) const
+		{
+			for (const std::string_view& f : Flags)
+			{
+				if (f == flag)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		static constexpr value_type& Get(class_type& object) { return object.*MemberPtr; }
+		static constexpr const value_type& Get(const class_type& object) { return object.*MemberPtr; }
+	};
+
+	/// <summary>
+	/// Compile time description of a reflected class/struct. Generated as __REFLECT_STATIC_CLASS__()
+	/// in every REFLECT_GENERATED_BODY().
+	/// </summary>
+	template<typename Class, std::size_t FlagCount, typename... Members>
+	struct StaticClass
+	{
+		using class_type = Class;
+		static constexpr std::size_t MemberCount = sizeof...(Members);
+
+		std::string_view Name;
+		std::array<std::string_view, FlagCount> Flags;
+		std::tuple<Members...> MemberList;
+	};
+
+	template<typename... Flags>
+	constexpr std::array<std::string_view, sizeof...(Flags)> MakeStaticFlags(Flags... flags)
+	{
+		return { std::string_view(flags)... };
+	}
+
+	template<auto MemberPtr, typename... Flags>
+	constexpr auto MakeStaticMember(std::string_view name, std::size_t offset, Flags... flags)
+	{
+		return StaticMember<MemberPtr, sizeof...(Flags)>{ name, offset, MakeStaticFlags(flags...) };
+	}
+
+	template<typename Class, std::size_t FlagCount, typename... Members>
+	constexpr auto MakeStaticClass(std::string_view name, std::array<std::string_view, FlagCount> flags, Members... members)
+	{
+		return StaticClass<Class, FlagCount, Members...>{ name, flags, std::make_tuple(members...) };
+	}
+
+	template<typename T>
+	constexpr auto GetStaticClass()
+	{
+		return T::__REFLECT_STATIC_CLASS__();
+	}
+
+	/// <summary>
+	/// Call 'func' with each StaticMember of 'T'.
+	/// </summary>
+	template<typename T, typename Func>
+	constexpr void ForEachStaticMember(Func&& func)
+	{
+		std::apply([&func](const auto&... member) { (func(member), ...); }, GetStaticClass<T>().MemberList);
+	}
+
+	/// <summary>
+	/// Call 'func' with each StaticMember of 'T' and a reference to that member in 'object'.
+	/// </summary>
+	template<typename T, typename Func>
+	constexpr void ForEachMemberValue(T& object, Func&& func)
+	{
+		std::apply([&func, &object](const auto&... member) { (func(member, member.Get(object)), ...); }, GetStaticClass<std::remove_const_t<T>>().MemberList);
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "Core/Allocator.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <cstring>
+#include <stdint.h>
+
+namespace Reflect
+{
+	/// <summary>
+	/// View of a string stored once in the StringInterner. Copying one is a pointer copy, and two
+	/// InternedStrings are equal only when they point at the same string, so comparing them doesn't read the characters.
+	/// The characters are NUL terminated and stay valid for the whole run.
+	/// Example: InternedString type = "int"; type == InternedString("int") // true
+	/// </summary>
+	class InternedString
+	{
+	public:
+		InternedString() = default;
+		REFLECT_API InternedString(std::string_view str);
+		InternedString(const std::string& str) : InternedString(std::string_view(str)) { }
+		InternedString(const char* str) : InternedString(std::string_view(str)) { }
+
+		std::string_view Get() const { return std::string_view(c_str(), size()); }
+		operator std::string_view() const { return Get(); }
+
+		const char* c_str() const { return m_string ? m_string : ""; }
+		size_t size() const
+		{
+			uint32_t length = 0;
+			if (m_string)
+			{
+				memcpy(&length, m_string - sizeof(length), sizeof(length));
+			}
+			return length;
+		}
+		bool empty() const { return m_string == nullptr; }
+		/// <summary>
+		/// Hash of the handle, not of the characters. Equal InternedStrings have the same hash.
+		/// </summary>
+		size_t Hash() const { return std::hash<const char*>()(m_string); }
+
+		bool operator==(const InternedString& other) const { return m_string == other.m_string; }
+		bool operator!=(const InternedString& other) const { return m_string != other.m_string; }
+
+		// Strings which are not interned are compared by their characters.
+		bool operator==(std::string_view other) const { return Get() == other; }
+		bool operator!=(std::string_view other) const { return !(*this == other); }
+		bool operator==(const std::string& other) const { return *this == std::string_view(other); }
+		bool operator!=(const std::string& other) const { return !(*this == std::string_view(other)); }
+		bool operator==(const char* other) const { return *this == std::string_view(other); }
+		bool operator!=(const char* other) const { return !(*this == std::string_view(other)); }
+
+	private:
+		explicit InternedString(const char* str, bool) : m_string(str) { }
+
+	private:
+		// Null is the empty string, so default constructing doesn't need the interner. The length is stored
+		// in front of the characters.
+		const char* m_string = nullptr;
+
+		friend class StringInterner;
+	};
+
+	inline std::string operator+(const InternedString& lhs, std::string_view rhs)
+	{
+		std::string str;
+		str.reserve(lhs.size() + rhs.size());
+		str.append(lhs.Get()).append(rhs);
+		return str;
+	}
+
+	inline std::string operator+(std::string lhs, const InternedString& rhs)
+	{
+		return lhs.append(rhs.Get());
+	}
+
+	/// <summary>
+	/// Stores each distinct string once for the whole run. Used by the parser for every string in the parsed model
+	/// (names, types and REFLECT flags), type names and flags are the same handful of strings repeated in every file.
+	/// The characters are copied into large blocks (ArenaAllocator) and looked up through a flat table, so interning
+	/// doesn't allocate per string. Safe to call from multiple threads, the strings are split over shards which each
+	/// have their own lock. Strings are never removed.
+	/// </summary>
+	class StringInterner
+	{
+	public:
+		REFLECT_API static StringInterner& Get();
+
+		REFLECT_API InternedString Intern(std::string_view str);
+
+		/// <summary>
+		/// Number of distinct strings and the number of characters stored for them.
+		/// </summary>
+		REFLECT_API size_t GetStringCount() const;
+		REFLECT_API size_t GetTotalBytes() const;
+
+	private:
+		static constexpr size_t ShardCount = 16;
+		static constexpr size_t ShardBlockSize = 16 * 1024;
+
+		struct Slot
+		{
+			uint64_t Hash;
+			const char* String;
+		};
+
+		struct Shard
+		{
+			mutable std::mutex Mutex;
+			// Open addressing, linear probing. The size is a power of two and at most half of it is used.
+			std::vector<Slot> Table;
+			size_t Count = 0;
+			size_t Bytes = 0;
+			ArenaAllocator Strings{ ShardBlockSize };
+		};
+
+		static void Grow(Shard& shard);
+
+	private:
+		Shard m_shards[ShardCount];
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<Reflect::InternedString>
+	{
+		size_t operator()(const Reflect::InternedString& str) const { return str.Hash(); }
+	};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Core/Core.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <string>
+
+namespace Reflect
+{
+	/// <summary>
+	/// Fixed number of worker threads taking tasks from a shared queue.
+	/// Tasks are run in the order they are submitted. Wait() blocks until every submitted task has finished.
+	/// The destructor waits for the queue to empty before joining the workers.
+	/// </summary>
+	class ThreadPool
+	{
+	public:
+		/// <summary>
+		/// Start 'threadCount' workers, 0 uses one per hardware thread. 'name' is used for the
+		/// profiler's thread names ("<name> 0", "<name> 1", ...).
+		/// </summary>
+		REFLECT_API ThreadPool(size_t threadCount = 0, const std::string& name = "Worker");
+		REFLECT_API ~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		REFLECT_API void Submit(std::function<void()> task);
+		REFLECT_API void Wait();
+
+		size_t GetThreadCount() const { return m_threads.size(); }
+
+		/// <summary>
+		/// Number of threads to use for the "threads" option. "0" or an invalid value use one per hardware thread.
+		/// </summary>
+		REFLECT_API static size_t ThreadCountFromString(const std::string& value);
+
+	private:
+		void WorkerThread(size_t index, std::string name);
+
+	private:
+		std::vector<std::thread> m_threads;
+		std::deque<std::function<void()>> m_tasks;
+		std::mutex m_mutex;
+		std::condition_variable m_taskAvailable;
+		std::condition_variable m_tasksFinished;
+		// Tasks which have been submitted but not finished (queued or running).
+		size_t m_pendingTasks = 0;
+		bool m_stopping = false;
+	};
+}
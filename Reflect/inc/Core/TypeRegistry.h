@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "Core/Hash.h"
+#include "Core/Allocator.h"
+#include "ReflectStructs.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+namespace Reflect
+{
+	template<typename T>
+	struct TypeInfoRange
+	{
+		T* Begin = nullptr;
+		T* End = nullptr;
+
+		T* begin() const { return Begin; }
+		T* end() const { return End; }
+		std::size_t size() const { return static_cast<std::size_t>(End - Begin); }
+		bool empty() const { return Begin == End; }
+	};
+
+	/// <summary>
+	/// Static metadata for a single reflected type. One is generated per reflected class/struct
+	/// and registers itself with the TypeRegistry when constructed.
+	/// </summary>
+	class TypeInfo
+	{
+	public:
+		// Construct the type in place in 'memory'.
+		using ConstructFunc = IReflect*(*)(void* memory);
+		// Call the destructor of the object which starts at 'memory'.
+		using DestructFunc = void(*)(void* memory);
+
+		REFLECT_API TypeInfo(const char* name, TypeId typeId, std::size_t typeSize, std::size_t typeAlignment, std::vector<std::string> inheritance,
+			ReflectMemberProp* members, std::size_t memberCount,
+			ReflectFunctionProp* functions, std::size_t functionCount,
+			ConstructFunc constructFunc, DestructFunc destructFunc,
+			ReflectMemberProp* allMembers = nullptr, std::size_t allMemberCount = 0,
+			ReflectFunctionProp* allFunctions = nullptr, std::size_t allFunctionCount = 0);
+		REFLECT_API ~TypeInfo();
+
+		TypeInfo(const TypeInfo&) = delete;
+		TypeInfo(TypeInfo&&) = delete;
+
+		const char* GetName() const { return m_name; }
+		TypeId GetTypeId() const { return m_typeId; }
+		std::size_t GetTypeSize() const { return m_typeSize; }
+		std::size_t GetTypeAlignment() const { return m_typeAlignment; }
+
+		/// <summary>
+		/// Base types as written in the source (ReflectContainerData::Inheritance).
+		/// </summary>
+		const std::vector<std::string>& GetInheritance() const { return m_inheritance; }
+		TypeInfoRange<ReflectMemberProp> GetMembers() const { return m_members; }
+		TypeInfoRange<ReflectFunctionProp> GetFunctions() const { return m_functions; }
+		/// <summary>
+		/// Members of this type and of every reflected base in one table, base members first. The offsets are
+		/// from the start of this type. The same as GetMembers if the bases couldn't be resolved when generating.
+		/// </summary>
+		TypeInfoRange<ReflectMemberProp> GetAllMembers() const { return m_allMembers; }
+		/// <summary>
+		/// Functions of this type and of every reflected base, base functions first. Call them with the
+		/// object pointer moved by ReflectFunctionProp::Offset.
+		/// </summary>
+		TypeInfoRange<ReflectFunctionProp> GetAllFunctions() const { return m_allFunctions; }
+		/// <summary>
+		/// True if GetAllMembers/GetAllFunctions have the members/functions of the bases too.
+		/// </summary>
+		bool HasResolvedBases() const { return m_hasResolvedBases; }
+
+		REFLECT_API const ReflectMemberProp* FindMember(std::string_view memberName) const;
+		REFLECT_API const ReflectFunctionProp* FindFunction(std::string_view functionName) const;
+
+		bool CanCreate() const { return m_constructFunc != nullptr; }
+
+		/// <summary>
+		/// Construct a new instance with memory from 'allocator'. Returns nullptr if the type is not default constructible
+		/// or 'allocator' can't give memory for it (a PoolAllocator with blocks which are too small).
+		/// Destroy must be called with the same allocator. An allocator which owns object lifetimes (ArenaAllocator, even
+		/// when passed as an IAllocator) runs the destructor itself when it is reset, Destroy is optional then.
+		/// </summary>
+		IReflect* Create(IAllocator& allocator = HeapAllocator::Get()) const
+		{
+			if (!CanCreate())
+			{
+				return nullptr;
+			}
+			void* memory = allocator.Allocate(m_typeSize, m_typeAlignment);
+			if (memory == nullptr)
+			{
+				return nullptr;
+			}
+			IReflect* object = m_constructFunc(memory);
+			allocator.AddCleanup(m_destructFunc, memory);
+			return object;
+		}
+
+		/// <summary>
+		/// Destruct 'object' and give its memory back to 'allocator'. Does nothing if 'allocator' owns object lifetimes,
+		/// the destructor is run once when the allocator is reset.
+		/// </summary>
+		void Destroy(IReflect* object, IAllocator& allocator = HeapAllocator::Get()) const
+		{
+			if (object && !allocator.OwnsObjectLifetimes())
+			{
+				// The allocation starts at the most derived object, not always at the IReflect base.
+				void* memory = dynamic_cast<void*>(object);
+				m_destructFunc(memory);
+				allocator.Deallocate(memory, m_typeSize, m_typeAlignment);
+			}
+		}
+
+		template<typename T>
+		static constexpr ConstructFunc GetConstructFunc()
+		{
+			if constexpr (std::is_default_constructible_v<T> && !std::is_abstract_v<T>)
+			{
+				// A C style cast converts to IReflect even when T doesn't inherit it publicly (class T : private Base).
+				return [](void* memory) -> IReflect* { return (IReflect*)new (memory) T(); };
+			}
+			else
+			{
+				return nullptr;
+			}
+		}
+
+		template<typename T>
+		static constexpr DestructFunc GetDestructFunc()
+		{
+			return [](void* memory) { static_cast<T*>(memory)->~T(); };
+		}
+
+	private:
+		const char* m_name;
+		TypeId m_typeId;
+		std::size_t m_typeSize;
+		std::size_t m_typeAlignment;
+		std::vector<std::string> m_inheritance;
+		TypeInfoRange<ReflectMemberProp> m_members;
+		TypeInfoRange<ReflectFunctionProp> m_functions;
+		TypeInfoRange<ReflectMemberProp> m_allMembers;
+		TypeInfoRange<ReflectFunctionProp> m_allFunctions;
+		bool m_hasResolvedBases;
+		ConstructFunc m_constructFunc;
+		DestructFunc m_destructFunc;
+	};
+
+	/// <summary>
+	/// Process wide lookup of all reflected types. Types are registered from the generated .cpp files
+	/// during static initialisation, after that the registry is read only so lookups take no locks.
+	/// </summary>
+	class TypeRegistry
+	{
+	public:
+		REFLECT_API static TypeRegistry& Get();
+
+		REFLECT_API void Register(const TypeInfo& typeInfo);
+		REFLECT_API void Unregister(const TypeInfo& typeInfo);
+
+		REFLECT_API const TypeInfo* Find(TypeId typeId) const;
+		const TypeInfo* Find(std::string_view typeName) const { return Find(GetTypeId(typeName)); }
+		template<typename T>
+		const TypeInfo* Find() const { return Find(T::StaticTypeId()); }
+
+		/// <summary>
+		/// Construct a new instance of the type 'typeName'. Returns nullptr if the type is unknown
+		/// or can't be default constructed.
+		/// </summary>
+		IReflect* Create(std::string_view typeName, IAllocator& allocator = HeapAllocator::Get()) const
+		{
+			const TypeInfo* typeInfo = Find(typeName);
+			return typeInfo ? typeInfo->Create(allocator) : nullptr;
+		}
+
+		const std::vector<const TypeInfo*>& GetAllTypes() const { return m_typeList; }
+
+	private:
+		TypeRegistry() { }
+
+	private:
+		std::unordered_map<TypeId, const TypeInfo*> m_types;
+		std::vector<const TypeInfo*> m_typeList;
+	};
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "ReflectStructs.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+namespace Reflect
+{
+	/// <summary>
+	/// Binary reflection database written by ReflectEXE (the database option) and read by ReflectDatabase.
+	/// It holds the parsed model of every header so other tools can use it without parsing anything.
+	///
+	/// Layout: the Header followed by one section per Section value, each aligned to SectionAlignment.
+	/// Every section is an array of the fixed size records below (bytes for Strings), so the file can be
+	/// memory mapped and used in place. Records point at each other with indices and at strings with
+	/// StringRefs, never with pointers. Files are sorted by SourcePath, the container index by NameHash.
+	/// Everything is stored in the byte order of the machine which wrote it (see ByteOrderMark).
+	/// </summary>
+	namespace DatabaseFormat
+	{
+		constexpr char Magic[4] = { 'R', 'F', 'D', 'B' };
+		constexpr uint32_t Version = 2;
+		// Reads back as something else on a machine with the other byte order.
+		constexpr uint32_t ByteOrderMark = 0x01020304;
+		constexpr uint32_t SectionAlignment = 8;
+		constexpr const char* FileExtension = ".rdb";
+
+		enum class Section : uint32_t
+		{
+			// NUL terminated strings, each preceded by its uint32 length.
+			Strings,
+			// StringRef lists (container props, inheritance, cpp includes).
+			StringLists,
+			Files,
+			Containers,
+			// TypeName records for members and function parameters.
+			Members,
+			Functions,
+			Parameters,
+			ContainerIndex,
+
+			Count
+		};
+
+		// Offset of a string's first character in the Strings section.
+		using StringRef = uint32_t;
+
+		struct SectionEntry
+		{
+			uint32_t Offset;
+			// Number of records (bytes for Strings).
+			uint32_t Count;
+		};
+
+		struct Header
+		{
+			char Magic[4];
+			uint32_t Version;
+			uint32_t ByteOrder;
+			uint32_t HeaderSize;
+			uint64_t FileSize;
+			SectionEntry Sections[static_cast<size_t>(Section::Count)];
+		};
+
+		struct Range
+		{
+			uint32_t First;
+			uint32_t Count;
+		};
+
+		/// <summary>
+		/// ReflectTypeNameData. Props is a range of StringLists.
+		/// </summary>
+		struct TypeName
+		{
+			StringRef Type;
+			StringRef Name;
+			int32_t TypeSize;
+			uint8_t ValueType;
+			uint8_t Modifier;
+			uint8_t IsConst;
+			uint8_t Padding;
+			Range Props;
+		};
+
+		/// <summary>
+		/// ReflectFunctionData. 'Return' is the return type and name of the function.
+		/// </summary>
+		struct Function
+		{
+			TypeName Return;
+			Range Parameters;
+		};
+
+		/// <summary>
+		/// ReflectContainerData. Inheritance is a range of StringLists, InheritanceAccess the matching
+		/// "public", "protected" or "private" of each base.
+		/// </summary>
+		struct Container
+		{
+			TypeName Type;
+			StringRef PrettyName;
+			// Index of the file the container is in.
+			uint32_t File;
+			int32_t GeneratedBodyLine;
+			uint8_t ReflectType;
+			uint8_t Padding[3];
+			Range Inheritance;
+			Range InheritanceAccess;
+			Range Members;
+			Range Functions;
+		};
+
+		/// <summary>
+		/// FileParsedData. SourcePath is the normalised path of the header, used to look files up.
+		/// CPPIncludes is a range of StringLists.
+		/// </summary>
+		struct File
+		{
+			StringRef SourcePath;
+			StringRef FilePath;
+			StringRef FileName;
+			StringRef FileExtension;
+			int32_t GeneratedBodyLineOffset;
+			uint32_t Padding;
+			Range CPPIncludes;
+			Range Containers;
+		};
+
+		struct ContainerIndexEntry
+		{
+			uint64_t NameHash;
+			uint32_t Container;
+			uint32_t Padding;
+		};
+
+		static_assert(sizeof(Header) == 24 + 8 * static_cast<size_t>(Section::Count), "Database header layout changed, bump the version.");
+		static_assert(sizeof(TypeName) == 24 && sizeof(Function) == 32 && sizeof(Container) == 72 && sizeof(File) == 40 && sizeof(ContainerIndexEntry) == 16,
+			"Database record layout changed, bump the version.");
+
+		/// <summary>
+		/// Path used as the SourcePath of a header, so "./a/b.h" and "a/b.h" find the same file.
+		/// </summary>
+		REFLECT_API std::string NormaliseSourcePath(const std::string& filePath);
+	}
+
+	/// <summary>
+	/// Collect the parsed files of a run and write them out as a reflection database.
+	/// </summary>
+	class ReflectDatabaseWriter
+	{
+	public:
+		/// <summary>
+		/// Add a parsed file. The file text (Data) isn't stored. Can be called from several threads at once.
+		/// </summary>
+		REFLECT_API void AddFile(FileParsedData data);
+		/// <summary>
+		/// Write every added file to 'filePath'. The file is written next to it first and then renamed,
+		/// so a reader never sees half a database.
+		/// </summary>
+		REFLECT_API bool Write(const std::string& filePath);
+
+		size_t GetFileCount() const { return m_files.size(); }
+
+	private:
+		std::mutex m_mutex;
+		std::vector<FileParsedData> m_files;
+	};
+
+	/// <summary>
+	/// Read only view of a reflection database. The file is memory mapped and checked once when opened,
+	/// after that every lookup works on the mapped records directly without copying or allocating.
+	/// Example:
+	///		ReflectDatabase database;
+	///		if (database.Open("Reflect.rdb"))
+	///		{
+	///			const DatabaseFormat::Container* player = database.FindContainer("Player");
+	///			for (const DatabaseFormat::TypeName& member : database.GetMembers(*player)) { database.GetString(member.Name); }
+	///		}
+	/// </summary>
+	class ReflectDatabase
+	{
+	public:
+		template<typename T>
+		struct View
+		{
+			const T* Data = nullptr;
+			uint32_t Count = 0;
+
+			const T* begin() const { return Data; }
+			const T* end() const { return Data + Count; }
+			uint32_t size() const { return Count; }
+			bool empty() const { return Count == 0; }
+			const T& operator[](uint32_t index) const { return Data[index]; }
+		};
+
+		REFLECT_API ReflectDatabase();
+		REFLECT_API ~ReflectDatabase();
+		ReflectDatabase(const ReflectDatabase&) = delete;
+		ReflectDatabase& operator=(const ReflectDatabase&) = delete;
+
+		/// <summary>
+		/// Map and check 'filePath'. Returns false (see GetError) if it can't be read, isn't a database,
+		/// is a different version or is corrupt.
+		/// </summary>
+		REFLECT_API bool Open(const std::string& filePath);
+		REFLECT_API void Close();
+		bool IsOpen() const { return m_data != nullptr; }
+		const std::string& GetError() const { return m_error; }
+
+		REFLECT_API std::string_view GetString(DatabaseFormat::StringRef ref) const;
+		View<DatabaseFormat::StringRef> GetStrings(DatabaseFormat::Range range) const { return GetRange<DatabaseFormat::StringRef>(DatabaseFormat::Section::StringLists, range); }
+
+		View<DatabaseFormat::File> GetFiles() const { return GetSection<DatabaseFormat::File>(DatabaseFormat::Section::Files); }
+		View<DatabaseFormat::Container> GetContainers() const { return GetSection<DatabaseFormat::Container>(DatabaseFormat::Section::Containers); }
+		View<DatabaseFormat::Container> GetContainers(const DatabaseFormat::File& file) const { return GetRange<DatabaseFormat::Container>(DatabaseFormat::Section::Containers, file.Containers); }
+		View<DatabaseFormat::TypeName> GetMembers(const DatabaseFormat::Container& container) const { return GetRange<DatabaseFormat::TypeName>(DatabaseFormat::Section::Members, container.Members); }
+		View<DatabaseFormat::Function> GetFunctions(const DatabaseFormat::Container& container) const { return GetRange<DatabaseFormat::Function>(DatabaseFormat::Section::Functions, container.Functions); }
+		View<DatabaseFormat::TypeName> GetParameters(const DatabaseFormat::Function& function) const { return GetRange<DatabaseFormat::TypeName>(DatabaseFormat::Section::Parameters, function.Parameters); }
+
+		/// <summary>
+		/// Find a container by name. Returns nullptr if there isn't one.
+		/// </summary>
+		REFLECT_API const DatabaseFormat::Container* FindContainer(std::string_view name) const;
+		/// <summary>
+		/// Find the file for the header at 'filePath'. Returns nullptr if there isn't one.
+		/// </summary>
+		REFLECT_API const DatabaseFormat::File* FindFile(const std::string& filePath) const;
+		/// <summary>
+		/// Rebuild the parsed data of 'file', as FileParser would give it (without the file text).
+		/// </summary>
+		REFLECT_API void GetFileParsedData(const DatabaseFormat::File& file, FileParsedData& data) const;
+
+	private:
+		bool Validate();
+		ReflectTypeNameData GetTypeNameData(const DatabaseFormat::TypeName& typeName, ArenaAllocator* arena) const;
+		std::vector<std::string> GetStringList(DatabaseFormat::Range range) const;
+
+		const DatabaseFormat::Header& GetHeader() const { return *reinterpret_cast<const DatabaseFormat::Header*>(m_data); }
+
+		template<typename T>
+		View<T> GetSection(DatabaseFormat::Section section) const
+		{
+			const DatabaseFormat::SectionEntry& entry = GetHeader().Sections[static_cast<size_t>(section)];
+			return { reinterpret_cast<const T*>(m_data + entry.Offset), entry.Count };
+		}
+
+		template<typename T>
+		View<T> GetRange(DatabaseFormat::Section section, DatabaseFormat::Range range) const
+		{
+			return { GetSection<T>(section).Data + range.First, range.Count };
+		}
+
+	private:
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+		// Platform handle of the mapping (Windows only).
+		void* m_mapping = nullptr;
+		std::string m_error;
+	};
+}
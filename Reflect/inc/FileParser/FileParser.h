@@ -21,6 +21,31 @@ namespace Reflect
 		REFLECT_API void ParseDirectory(const std::string& directory, const ReflectAddtionalOptions& addtionalOptions);
 		REFLECT_API void SetIgnoreStrings(const std::vector<std::string>& ignoreStrings);
 
+		/// <summary>
+		/// Set the options used by ParseFile. ParseDirectory sets these itself.
+		/// </summary>
+		REFLECT_API void SetOptions(const ReflectAddtionalOptions& addtionalOptions);
+		/// <summary>
+		/// Find every header in 'directory' (and its sub directories) which should be parsed.
+		/// </summary>
+		REFLECT_API std::vector<std::string> CollectFiles(const std::string& directory);
+		/// <summary>
+		/// Read the headers to parse from a file list (a response file), one path per line. "-" reads the list
+		/// from stdin. Entries which aren't headers, are generated files or don't exist are skipped.
+		/// </summary>
+		REFLECT_API std::vector<std::string> CollectFilesFromList(const std::string& listPath);
+		/// <summary>
+		/// True if 'filePath' is in shard 'shardIndex' of 'shardCount'. The shard comes from a hash of the path,
+		/// so a header stays in the same shard when others are added or removed.
+		/// </summary>
+		REFLECT_API static bool IsInShard(const std::string& filePath, size_t shardIndex, size_t shardCount);
+		/// <summary>
+		/// Load and parse a single header. Returns false if there is nothing to reflect in it.
+		/// This doesn't change the parser, so it can be called from several threads at once as long as
+		/// SetOptions/SetIgnoreStrings aren't called at the same time.
+		/// </summary>
+		REFLECT_API bool ParseFile(const std::string& filePath, FileParsedData& fileData);
+
 		REFLECT_API const FileParsedData& GetFileParsedData(int index) const { return m_filesParsed.at(index); }
 		REFLECT_API const std::vector<FileParsedData>& GetAllFileParsedData() const { return m_filesParsed; }
 
@@ -31,22 +56,30 @@ namespace Reflect
 		bool CheckExtension(const std::string& filePath, std::vector<const char*> extensions);
 		bool CheckIfAutoGeneratedFile(const std::string& filePath);
 
-		FileParsedData LoadFile(std::ifstream& file);
+		FileParsedData LoadFile(const std::string& filePath);
 
 
 		bool ParseFile(FileParsedData& fileData);
-		bool ReflectContainerHeader(FileParsedData& fileData, const std::string& keyword, const EReflectType type);
+		bool ReflectContainerHeader(FileParsedData& fileData, std::string_view keyword, const EReflectType type);
 		void ReflectContainer(FileParsedData& fileData);
 		void GetAllCPPIncludes(FileParsedData& fileData);
 
 		int FindEndOfConatiner(const FileParsedData& fileData);
-		std::vector<std::string> ReflectFlags(FileParsedData& fileData);
+		/// <summary>
+		/// Where the next REFLECT_STRUCT/REFLECT_CLASS is from 'cursor', std::string::npos if there isn't one.
+		/// </summary>
+		size_t FindNextContainerKey(const FileParsedData& fileData, size_t cursor) const;
+		ModelVector<InternedString> ReflectFlags(FileParsedData& fileData);
 
 		char FindNextChar(FileParsedData& fileData, const std::vector<char>& ignoreChars);
 		char FindNextChar(FileParsedData const& fileData, int& cursor, const std::vector<char>& ignoreChars);
 		char FindNextChar(FileParsedData& fileData, char charToFind);
+		/// <summary>
+		/// Where FindNextChar would move the cursor to, without moving it.
+		/// </summary>
+		int FindNextCharCursor(const FileParsedData& fileData, int cursor, char charToFind) const;
 
-		std::string FindNextWord(FileParsedData& fileData, const std::vector<char>& endChars);
+		std::string_view FindNextWord(FileParsedData& fileData, const std::vector<char>& endChars);
 		bool IsWordReflectKey(std::string_view view);
 
 		bool CheckForTypeAlias(std::string_view view);
@@ -54,15 +87,16 @@ namespace Reflect
 		bool CheckForConstructor(FileParsedData& fileData, ReflectContainerData& container, std::string_view view);
 		bool CheckForIgnoreWord(FileParsedData& fileData, std::string_view view);
 		bool CheckForOperatorFunction(FileParsedData& fileData, std::string_view view);
-		bool CheckForComments(FileParsedData& fileData, std::string& line);
+		bool CheckForComments(FileParsedData& fileData, std::string_view view);
 		bool CheckForFriends(FileParsedData& fileData, std::string_view view);
 
 		void GetReflectNameAndReflectValueTypeAndReflectModifer(std::string& str, std::string& name, EReflectValueType& valueType, EReflectValueModifier& modifer);
 
-		ReflectFunctionData GetFunction(FileParsedData& fileData, const std::vector<std::string>& flags);
-		ReflectMemberData GetMember(FileParsedData& fileData, const std::vector<std::string>& flags);
+		ReflectFunctionData GetFunction(FileParsedData& fileData, const ModelVector<InternedString>& flags);
+		ReflectMemberData GetMember(FileParsedData& fileData, const ModelVector<InternedString>& flags);
 
 		void SkipFunctionBody(FileParsedData& fileData);
+		int SkipFunctionBody(const FileParsedData& fileData, int cursor);
 
 		EReflectType CheckForReflectType(FileParsedData& data);
 
@@ -70,18 +104,21 @@ namespace Reflect
 		EReflectValueType CheckForRefOrPtr(std::string_view view);
 		EReflectValueModifier CheckForMemberModifers(std::string_view view);
 
-		std::string GetFunctionLine(const FileParsedData& fileData, int& endCursor);
-		std::vector<ReflectTypeNameData> ReflectGetFunctionParameters(const FileParsedData& fileData, std::string_view view);
+		std::string_view GetFunctionLine(const FileParsedData& fileData, int& endCursor);
+		ModelVector<ReflectTypeNameData> ReflectGetFunctionParameters(const FileParsedData& fileData, std::string_view view);
 
 		void CheckStringViewBounds(const FileParsedData& fileData, int cursor, std::string_view view);
 		int CountNumberOfSinceTop(const FileParsedData& fileData, int cursorStart, const char& character);
 
 		std::string PrettyString(std::string str);
 
+		void CheckParseTime(const char* kind, const std::string& name, int64_t parseTime) const;
+
 	private:
 		std::vector<FileParsedData> m_filesParsed;
-		std::vector<std::string> m_filesToRemove;
 		std::vector<std::string> m_ignoreStrings;
 		ReflectAddtionalOptions m_options;
+		// Parse time in nanoseconds above which a warning is logged, 0 to disable.
+		int64_t m_parseWarnTime = 0;
 	};
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "ReflectStructs.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Reflect
+{
+	class FileParser;
+
+	/// <summary>
+	/// The headers read in one run, each parsed once by whichever thread asks for it first. The headers to reflect
+	/// are parsed through it, and so are the headers they include when InheritanceResolver looks for bases in them.
+	/// Headers are found by their normalised path, so "./a/b.h" and "a/b.h" are the same header.
+	/// Safe to call from several threads at once.
+	/// </summary>
+	class HeaderCache
+	{
+	public:
+		REFLECT_API explicit HeaderCache(FileParser& parser);
+		REFLECT_API ~HeaderCache();
+
+		/// <summary>
+		/// Parse 'headerPath', or give the data from the first time it was parsed. nullptr if there is nothing
+		/// to reflect in it. The text of the header isn't kept. The data doesn't move until the cache is destroyed.
+		/// </summary>
+		REFLECT_API FileParsedData* Parse(const std::string& headerPath);
+		/// <summary>
+		/// Every header 'headerPath' includes with #include "...", directly or not, sorted. An include is looked for
+		/// next to the header which includes it; ones which aren't there (they come from the include paths) and
+		/// generated headers are left out. Only reads the headers, they aren't parsed.
+		/// </summary>
+		REFLECT_API std::vector<std::string> GetIncludedHeaders(const std::string& headerPath);
+		/// <summary>
+		/// Move the parsed data of 'headerPath' out of the cache. Only call once no other thread uses it.
+		/// </summary>
+		REFLECT_API bool Take(const std::string& headerPath, FileParsedData& data);
+
+		/// <summary>
+		/// The normalised path of a header, the key used by the cache.
+		/// </summary>
+		REFLECT_API static std::string NormalisePath(const std::string& headerPath);
+
+	private:
+		struct Entry
+		{
+			std::once_flag ParseOnce;
+			std::once_flag IncludesOnce;
+			bool Reflected = false;
+			FileParsedData Data;
+			// Normalised paths of the headers included directly.
+			std::vector<std::string> Includes;
+		};
+
+		Entry& GetEntry(const std::string& normalisedPath);
+		void ReadIncludes(Entry& entry, const std::string& normalisedPath, const std::string* text);
+
+	private:
+		FileParser& m_parser;
+		std::mutex m_mutex;
+		std::unordered_map<std::string, std::unique_ptr<Entry>> m_entries;
+	};
+}
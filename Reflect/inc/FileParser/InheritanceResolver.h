@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "ReflectStructs.h"
+#include "FileParser/HeaderCache.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Reflect
+{
+	/// <summary>
+	/// Resolve the bases of the reflected containers in a header. The code generation then writes a flattened
+	/// member/function table for each container, with the inherited members at their offset in the derived type,
+	/// so whole hierarchy queries are one scan instead of a walk up the __super chain.
+	/// Bases are looked for in the header and the headers it includes (HeaderCache::GetIncludedHeaders), the same
+	/// ones the compiler sees, so a header gets the same generated code whichever other headers are in the run.
+	/// A container is only resolved if every base it has, direct or not, is reflected (or REFLECT_BASE()),
+	/// is inherited publicly, has a unique name, and appears once in the hierarchy. Otherwise it keeps using the __super chain.
+	/// Safe to call from several threads at once.
+	/// </summary>
+	class InheritanceResolver
+	{
+	public:
+		REFLECT_API explicit InheritanceResolver(HeaderCache& headers);
+
+		/// <summary>
+		/// Set ResolvedBases of every container in 'data', and IncludedHeaders to the headers the bases were looked for in.
+		/// Included headers which haven't been parsed yet are parsed through the cache.
+		/// </summary>
+		REFLECT_API void Resolve(FileParsedData& data) const;
+
+	private:
+		struct ContainerEntry
+		{
+			const ReflectContainerData* Container;
+			const FileParsedData* File;
+		};
+		using ContainerMap = std::unordered_map<InternedString, std::vector<ContainerEntry>>;
+
+		bool CollectBases(const ContainerMap& containers, const ReflectContainerData& container, std::vector<const ContainerEntry*>& bases, size_t depth) const;
+
+	private:
+		HeaderCache& m_headers;
+	};
+}
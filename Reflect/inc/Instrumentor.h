@@ -1,128 +1,627 @@
 #pragma once
 #include "Core/Compiler.h"
+#include "Core/Log.h"
+#include "TraceFormat.h"
 
-#include <sstream>
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <iomanip>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <algorithm>
 #include <fstream>
-#include <iosfwd>
+#include <string>
+#include <set>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Define REFLECT_PROFILE_USE_RDTSC to timestamp events with the cpu's time stamp counter instead of
+// std::chrono::steady_clock. Ignored on platforms without rdtsc.
+#if defined(REFLECT_PROFILE_USE_RDTSC) && (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#define REFLECT_PROFILE_RDTSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define REFLECT_PROFILE_RDTSC 0
+#endif
 
 namespace Reflect::Profile
 {
 	using FloatingPointMicroseconds = std::chrono::duration<double, std::micro>;
 
-	struct ProfileResult
+	enum class ProfileState
 	{
-		std::string Name;
+		StartCapture,
+		StopCapture,
+		SaveCapture,
+	};
+
+	using StateChangedCallback = void(*)(ProfileState state);
+	// Allocator used for the profiler's own buffers, so they don't show up in the tracked memory.
+	using AllocateFunc = void*(*)(size_t size);
+	using DeallocateFunc = void(*)(void* memory);
+	// Called with the number of live bytes each time the "Memory" counter is updated.
+	using MemoryCallback = void(*)(int64_t liveBytes);
+
+	/// <summary>
+	/// Timestamp source for profile events. With rdtsc the events are recorded in cpu ticks and converted to
+	/// nanoseconds when the session is written out, which keeps the cost of a scope down to a few ns.
+	/// </summary>
+	struct ProfileClock
+	{
+		static int64_t Now()
+		{
+#if REFLECT_PROFILE_RDTSC
+			return static_cast<int64_t>(__rdtsc());
+#else
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		// Convert a value returned by Now() to steady_clock nanoseconds.
+		static int64_t ToNanoseconds(int64_t ticks)
+		{
+#if REFLECT_PROFILE_RDTSC
+			const Calibration& calibration = GetCalibration();
+			return calibration.SteadyBase + static_cast<int64_t>((ticks - calibration.TickBase) * calibration.NanosecondsPerTick);
+#else
+			return ticks;
+#endif
+		}
 
-		FloatingPointMicroseconds Start;
-		std::chrono::microseconds ElapsedTime;
-		std::thread::id ThreadID;
+		// Convert the difference between two values returned by Now() to nanoseconds.
+		static int64_t ToNanosecondsDuration(int64_t ticks)
+		{
+#if REFLECT_PROFILE_RDTSC
+			return static_cast<int64_t>(ticks * GetCalibration().NanosecondsPerTick);
+#else
+			return ticks;
+#endif
+		}
+
+		// Measure the tick rate now rather than when the first events are converted. Called when a session begins.
+		static void Calibrate()
+		{
+#if REFLECT_PROFILE_RDTSC
+			GetCalibration();
+#endif
+		}
+
+#if REFLECT_PROFILE_RDTSC
+	private:
+		struct Calibration
+		{
+			int64_t TickBase;
+			int64_t SteadyBase;
+			double NanosecondsPerTick;
+		};
+
+		static const Calibration& GetCalibration()
+		{
+			// Measured once. Calibrate() does it when the first session begins so the sleep doesn't land inside a recorded scope.
+			static const Calibration calibration = []()
+			{
+				auto steadyNow = []() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); };
+				int64_t tickStart = static_cast<int64_t>(__rdtsc());
+				int64_t steadyStart = steadyNow();
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				int64_t tickEnd = static_cast<int64_t>(__rdtsc());
+				int64_t steadyEnd = steadyNow();
+				return Calibration{ tickStart, steadyStart, static_cast<double>(steadyEnd - steadyStart) / static_cast<double>(tickEnd - tickStart) };
+			}();
+			return calibration;
+		}
+#endif
 	};
 
-	struct InstrumentationSession
+	/// <summary>
+	/// Named group of scopes which can be turned on/off at runtime. Categories are never destroyed so
+	/// REFLECT_PROFILE_CATEGORY can keep a pointer to them in a static.
+	/// </summary>
+	struct ProfileCategory
 	{
+		ProfileCategory(const char* name, bool enabled)
+			: Name(name), Enabled(enabled)
+		{ }
+
 		std::string Name;
+		std::atomic<bool> Enabled;
+	};
+
+	/// <summary>
+	/// Single producer/single consumer ring buffer of events. Each thread owns one and is the only writer,
+	/// the Instrumentor drains it. When the buffer is full new events are dropped rather than blocking.
+	/// </summary>
+	class ThreadEventBuffer
+	{
+	public:
+		ThreadEventBuffer(uint32_t threadId, size_t capacity, AllocateFunc allocate, DeallocateFunc deallocate)
+			: m_head(0)
+			, m_cachedTail(0)
+			, m_tail(0)
+			, m_dropped(0)
+			, m_threadId(threadId)
+			, m_deallocate(deallocate)
+			, m_nameWritten(false)
+		{
+			m_capacity = 1;
+			while (m_capacity < capacity)
+			{
+				m_capacity <<= 1;
+			}
+			m_events = static_cast<ProfileEvent*>(allocate(sizeof(ProfileEvent) * m_capacity));
+			// Touch the memory up front so the page faults don't land inside the first recorded scopes.
+			memset(m_events, 0, sizeof(ProfileEvent) * m_capacity);
+		}
+		~ThreadEventBuffer()
+		{
+			m_deallocate(m_events);
+		}
+
+		ThreadEventBuffer(const ThreadEventBuffer&) = delete;
+		ThreadEventBuffer(ThreadEventBuffer&&) = delete;
+
+		bool Push(const ProfileEvent& event)
+		{
+			uint64_t head = m_head.load(std::memory_order_relaxed);
+			if (head - m_cachedTail >= m_capacity)
+			{
+				// Only read the consumer's cache line when the buffer looks full.
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+				if (head - m_cachedTail >= m_capacity)
+				{
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+			}
+			m_events[head & (m_capacity - 1)] = event;
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		/// Call 'func' for every event written since the last drain. Only one thread may drain at a time.
+		/// </summary>
+		template<typename Func>
+		size_t Drain(Func&& func)
+		{
+			uint64_t tail = m_tail.load(std::memory_order_relaxed);
+			uint64_t head = m_head.load(std::memory_order_acquire);
+			for (uint64_t i = tail; i < head; ++i)
+			{
+				func(m_events[i & (m_capacity - 1)]);
+			}
+			m_tail.store(head, std::memory_order_release);
+			return static_cast<size_t>(head - tail);
+		}
+
+		uint32_t GetThreadId() const { return m_threadId; }
+		uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+		// Note: the name is shared with the thread saving the session, Instrumentor must hold a lock.
+		const std::string& GetName() const { return m_name; }
+		void SetName(const std::string& name) { m_name = name; m_nameWritten = false; }
+		bool IsNameWritten() const { return m_nameWritten; }
+		void SetNameWritten() { m_nameWritten = true; }
+
+	private:
+		alignas(64) std::atomic<uint64_t> m_head;
+		// Last value of m_tail seen by the writer, only used by the writer.
+		uint64_t m_cachedTail;
+		alignas(64) std::atomic<uint64_t> m_tail;
+		std::atomic<uint64_t> m_dropped;
+		uint32_t m_threadId;
+		size_t m_capacity;
+		ProfileEvent* m_events;
+		DeallocateFunc m_deallocate;
+		std::string m_name;
+		bool m_nameWritten;
+	};
+
+	struct StreamingOptions
+	{
+		// Maximum number of bytes of formatted json held in memory before it is written to disk.
+		size_t MaxPendingBytes = 1024 * 1024;
+		// How often the writer thread drains the thread buffers.
+		std::chrono::milliseconds FlushInterval = std::chrono::milliseconds(100);
 	};
 
 	class Instrumentor
 	{
 	public:
+		static constexpr size_t DefaultThreadBufferCapacity = 1 << 16;
+		// Minimum change in live bytes before a new "Memory" counter event is written.
+		static constexpr int64_t MemoryCounterGranularity = 64 * 1024;
+
 		Instrumentor()
-			: m_CurrentSession(nullptr)
+			: m_sessionActive(false)
+			, m_sessionStart(0)
+			, m_sessionEnd(0)
+			, m_activeSessions(0)
+			, m_enabled(true)
+			, m_nextThreadId(0)
+			, m_stateCallback(nullptr)
+			, m_allocate([](size_t size) { return ::operator new(size); })
+			, m_deallocate([](void* memory) { ::operator delete(memory); })
+			, m_memoryCallback(nullptr)
+			, m_liveBytes(0)
+			, m_peakBytes(0)
+			, m_reportedBytes(0)
+			, m_streamFile(nullptr)
+			, m_streamStart(0)
+			, m_streamEventCount(0)
+			, m_streamStop(false)
 		{ }
 		~Instrumentor()
-		{}
+		{
+			// Only Get() streams. Temporary instances (REFLECT_PROFILE_START_CAPTURE) must not end its session.
+			if (this == &Get())
+			{
+				EndStreamingSession();
+			}
+			else if (m_sessionActive)
+			{
+				// Otherwise Get() would keep the events of this session forever.
+				EndSession();
+			}
+		}
 
 		Instrumentor(const Instrumentor&) = delete;
 		Instrumentor(Instrumentor&&) = delete;
 
+		/// <summary>
+		/// Start recording. Any instance can be used to capture a window of time, the events themselves
+		/// are always recorded into the per thread buffers owned by Get().
+		/// </summary>
 		void BeginSession()
 		{
-			std::cout << "Temp profile started!" << std::endl;
-
-			std::lock_guard lock(m_Mutex);
-
-			if (&Get() != this)
+			if (m_sessionActive)
 			{
-				Get().AddProfile(this);
+				Log_Warn("[Instrumentor::BeginSession] Session already open.");
+				return;
 			}
-
-			if (m_CurrentSession)
+			ProfileClock::Calibrate();
+			m_sessionActive = true;
+			m_sessionStart = Now();
+			m_sessionEnd = INT64_MAX;
 			{
-				std::cout << "Instrumentor::BeginSession: Session already open." << std::endl;
-				return;
+				std::lock_guard lock(Get().m_Mutex);
+				Get().m_openSessionStarts.insert(m_sessionStart);
 			}
-			m_CurrentSession = new InstrumentationSession({ "" });
-			WriteHeader();
+			Get().m_activeSessions.fetch_add(1, std::memory_order_relaxed);
+			Get().OnStateChanged(ProfileState::StartCapture);
 		}
 
 		void EndSession()
 		{
-			std::lock_guard lock(m_Mutex);
-			if (&Get() != this)
+			if (m_sessionActive)
 			{
-				Get().RemoveProfile(this);
+				m_sessionActive = false;
+				m_sessionEnd = Now();
+				{
+					std::lock_guard lock(Get().m_Mutex);
+					Get().m_openSessionStarts.erase(Get().m_openSessionStarts.find(m_sessionStart));
+				}
+				Get().m_activeSessions.fetch_sub(1, std::memory_order_relaxed);
+				Get().OnStateChanged(ProfileState::StopCapture);
 			}
-			InternalEndSession();
+			Log_Info("Logging has finished.");
 		}
 
+		/// <summary>
+		/// Convert all the events recorded between BeginSession and EndSession to Chrome trace json.
+		/// Once saved, the events which no open session needs are released, so an ended session can only be saved once.
+		/// </summary>
 		void SaveSession(const std::string& filePath)
 		{
-			m_OutputStream.open(filePath);
-			if (m_OutputStream.is_open())
+			Instrumentor& global = Get();
+			global.OnStateChanged(ProfileState::SaveCapture);
+			InternalScope internal;
+			std::lock_guard lock(global.m_Mutex);
+			global.CollectEvents();
+
+			std::string json;
+			json.reserve(global.m_events.size() * 96 + 128);
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(global.GetDroppedCount()));
+			json += "{\"otherData\": {\"droppedEvents\":";
+			json += buffer;
+			json += "},\"traceEvents\":[{}";
+			global.ForEachThreadName([&json](uint32_t threadId, const char* name)
+				{
+					json += ',';
+					WriteThreadNameJson(json, threadId, name);
+				});
+			for (const ProfileEvent& event : global.m_events)
+			{
+				if (event.Start >= m_sessionStart && event.Start <= m_sessionEnd)
+				{
+					json += ',';
+					WriteEventJson(json, ToOutputEvent(event));
+				}
+			}
+			json += "]}";
+			global.ReleaseSavedEvents();
+
+			std::ofstream outputStream(filePath, std::ios::binary | std::ios::trunc);
+			if (outputStream.is_open())
+			{
+				outputStream.write(json.data(), json.size());
+				outputStream.close();
+				Log_Info("Profile has been saved to '%s'.", filePath.c_str());
+			}
+			else
+			{
+				Log_Error("Profile could not be saved to '%s'.", filePath.c_str());
+			}
+		}
+
+		/// <summary>
+		/// Same as SaveSession but writes the compact TraceFormat binary file. Use ReflectTraceConverter
+		/// to turn it into Chrome trace json. Releases the saved events like SaveSession.
+		/// </summary>
+		void SaveSessionBinary(const std::string& filePath)
+		{
+			Instrumentor& global = Get();
+			global.OnStateChanged(ProfileState::SaveCapture);
+			InternalScope internal;
+			std::lock_guard lock(global.m_Mutex);
+			global.CollectEvents();
+
+			TraceFormat::Writer writer;
+			writer.WriteDropped(global.GetDroppedCount());
+			global.ForEachThreadName([&writer](uint32_t threadId, const char* name)
+				{
+					writer.WriteThreadName(threadId, name);
+				});
+			for (const ProfileEvent& event : global.m_events)
+			{
+				if (event.Start >= m_sessionStart && event.Start <= m_sessionEnd)
+				{
+					writer.WriteEvent(ToOutputEvent(event));
+				}
+			}
+			global.ReleaseSavedEvents();
+
+			std::ofstream outputStream(filePath, std::ios::binary | std::ios::trunc);
+			if (outputStream.is_open())
 			{
-				m_OutputStream << m_dataString;
-				m_OutputStream.close();
+				outputStream.write(writer.GetData().data(), writer.GetData().size());
+				outputStream.close();
+				Log_Info("Profile has been saved to '%s'.", filePath.c_str());
 			}
 			else
 			{
-				std::cout << "Profile could not be saved to file." << std::endl;
+				Log_Error("Profile could not be saved to '%s'.", filePath.c_str());
 			}
-			std::cout << "Profile has been saved." << std::endl;
 		}
 
-		void WriteProfile(const ProfileResult& result)
+		/// <summary>
+		/// Start writing events to 'filePath' from a background thread while the program runs. Events are
+		/// written in the json array format without the closing bracket so the file can still be loaded if
+		/// the process never reaches EndStreamingSession. While streaming, drained events are written to
+		/// the file instead of being kept for SaveSession.
+		/// </summary>
+		bool BeginStreamingSession(const std::string& filePath, StreamingOptions options = {})
 		{
-			std::stringstream json;
+			Instrumentor& global = Get();
+			if (&global != this)
+			{
+				return global.BeginStreamingSession(filePath, options);
+			}
 
-			json << std::setprecision(3) << std::fixed;
-			json << ",{";
-			json << "\"cat\":\"function\",";
-			json << "\"dur\":" << (result.ElapsedTime.count()) << ',';
-			json << "\"name\":\"" << result.Name << "\",";
-			json << "\"ph\":\"X\",";
-			json << "\"pid\":0,";
-			json << "\"tid\":" << result.ThreadID << ",";
-			json << "\"ts\":" << result.Start.count();
-			json << "}";
+			if (m_streamThread.joinable())
+			{
+				Log_Warn("[Instrumentor::BeginStreamingSession] Streaming session already open.");
+				return false;
+			}
 
-			std::lock_guard lock(m_Mutex);
-			if (m_CurrentSession)
+			InternalScope internal;
+			m_streamFile = fopen(filePath.c_str(), "wb");
+			if (m_streamFile == nullptr)
 			{
-				m_dataString += json.str();
+				Log_Error("[Instrumentor::BeginStreamingSession] Could not open '%s'.", filePath.c_str());
+				return false;
+			}
+			fputs("[", m_streamFile);
+			fflush(m_streamFile);
+
+			ProfileClock::Calibrate();
+			m_streamOptions = options;
+			m_streamStart = Now();
+			m_streamEventCount = 0;
+			m_streamStop = false;
+			m_activeSessions.fetch_add(1, std::memory_order_relaxed);
+			m_streamThread = std::thread([this]() { StreamThread(); });
+			return true;
+		}
+
+		void EndStreamingSession()
+		{
+			Instrumentor& global = Get();
+			if (&global != this)
+			{
+				global.EndStreamingSession();
+				return;
+			}
+
+			if (!m_streamThread.joinable())
+			{
+				return;
 			}
 
-			for (auto& profile : m_profiles)
 			{
-				profile->m_dataString += json.str();
+				std::lock_guard lock(m_streamMutex);
+				m_streamStop = true;
 			}
+			m_streamCondition.notify_one();
+			m_streamThread.join();
+			m_activeSessions.fetch_sub(1, std::memory_order_relaxed);
+
+			fputs("\n]\n", m_streamFile);
+			fclose(m_streamFile);
+			m_streamFile = nullptr;
+		}
+
+		/// <summary>
+		/// Record a completed scope. Lock free: the event is written into the calling thread's ring buffer.
+		/// </summary>
+		void WriteEvent(const char* name, int64_t start, int64_t duration, const char* category = nullptr)
+		{
+			Push(ProfileEventType::Scope, name, category, start, duration);
+		}
+
+		/// <summary>
+		/// Record a single point in time with a value attached (REFLECT_PROFILE_TAG).
+		/// </summary>
+		void WriteInstant(const char* name, int64_t value, const char* category = nullptr)
+		{
+			Push(ProfileEventType::Instant, name, category, Now(), value);
 		}
 
-		void AddProfile(Instrumentor* ptr)
+		/// <summary>
+		/// Set the value of the counter track 'name' (REFLECT_PROFILE_COUNTER).
+		/// </summary>
+		void WriteCounter(const char* name, int64_t value, const char* category = nullptr)
 		{
-			std::lock_guard lock(m_Mutex);
-			m_profiles.push_back(ptr);
+			Push(ProfileEventType::Counter, name, category, Now(), value);
 		}
 
-		void RemoveProfile(Instrumentor* ptr)
+		/// <summary>
+		/// Name the calling thread in the trace.
+		/// </summary>
+		void SetThreadName(const std::string& name)
 		{
-			std::lock_guard lock(m_Mutex);
-			m_profiles.erase(std::find(m_profiles.begin(), m_profiles.end(), ptr));
+			InternalScope internal;
+			ThreadEventBuffer& buffer = GetThreadBuffer();
+			std::lock_guard lock(m_threadMutex);
+			buffer.SetName(name);
+		}
+
+		/// <summary>
+		/// Get or create the category 'name'. New categories are enabled unless a category filter is set
+		/// which doesn't contain them.
+		/// </summary>
+		ProfileCategory* GetCategory(const char* name)
+		{
+			InternalScope internal;
+			std::lock_guard lock(m_categoryMutex);
+			for (auto& category : m_categories)
+			{
+				if (category->Name == name)
+				{
+					return category.get();
+				}
+			}
+			m_categories.push_back(std::make_unique<ProfileCategory>(name, IsCategoryInFilter(name)));
+			return m_categories.back().get();
+		}
+
+		void SetCategoryEnabled(const char* name, bool enabled)
+		{
+			GetCategory(name)->Enabled.store(enabled, std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Only record the categories in the comma separated list 'filter'. An empty filter enables every category.
+		/// Scopes without a category are always recorded.
+		/// </summary>
+		void SetCategoryFilter(const std::string& filter)
+		{
+			InternalScope internal;
+			std::lock_guard lock(m_categoryMutex);
+			m_categoryFilter.clear();
+			size_t start = 0;
+			while (start < filter.size())
+			{
+				size_t end = std::min(filter.find(',', start), filter.size());
+				if (end > start)
+				{
+					m_categoryFilter.push_back(filter.substr(start, end - start));
+				}
+				start = end + 1;
+			}
+			for (auto& category : m_categories)
+			{
+				category->Enabled.store(IsCategoryInFilter(category->Name), std::memory_order_relaxed);
+			}
+		}
+
+		void SetStateChangedCallback(StateChangedCallback callback)
+		{
+			m_stateCallback = callback;
+		}
+
+		/// <summary>
+		/// Set the allocator used for the profiler's own buffers and the callback for memory counter updates.
+		/// Must be called before any thread records an event.
+		/// </summary>
+		void SetMemoryAllocator(AllocateFunc allocate, DeallocateFunc deallocate, MemoryCallback callback)
+		{
+			std::lock_guard lock(m_threadMutex);
+			if (!m_threadBuffers.empty())
+			{
+				Log_Error("[Instrumentor::SetMemoryAllocator] Must be called before any events are recorded.");
+			}
+			else if (allocate && deallocate)
+			{
+				m_allocate = allocate;
+				m_deallocate = deallocate;
+			}
+			m_memoryCallback = callback;
+		}
+
+		/// <summary>
+		/// Track a heap allocation (positive 'bytes') or deallocation (negative 'bytes'). The live total is written
+		/// to the "Memory" counter track every MemoryCounterGranularity bytes. Allocations made by the profiler
+		/// itself are ignored.
+		/// </summary>
+		void RecordAllocation(int64_t bytes)
+		{
+			if (InternalDepth() > 0)
+			{
+				return;
+			}
+
+			int64_t live = m_liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+			int64_t peak = m_peakBytes.load(std::memory_order_relaxed);
+			while (live > peak && !m_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+			{ }
+
+			int64_t reported = m_reportedBytes.load(std::memory_order_relaxed);
+			if ((live - reported >= MemoryCounterGranularity || reported - live >= MemoryCounterGranularity)
+				&& m_reportedBytes.compare_exchange_strong(reported, live, std::memory_order_relaxed))
+			{
+				InternalScope internal;
+				WriteCounter("Memory", live, "Memory");
+				if (m_memoryCallback)
+				{
+					m_memoryCallback(live);
+				}
+			}
+		}
+
+		int64_t GetLiveBytes() const { return m_liveBytes.load(std::memory_order_relaxed); }
+		int64_t GetPeakBytes() const { return m_peakBytes.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Turn recording on/off at runtime without ending the session. Scopes cost a couple of relaxed loads
+		/// while disabled.
+		/// </summary>
+		void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+		bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+		bool IsRecording() const { return m_activeSessions.load(std::memory_order_relaxed) > 0 && IsEnabled(); }
+
+		static int64_t Now()
+		{
+			return ProfileClock::Now();
 		}
 
 		static Instrumentor& Get()
@@ -130,46 +629,255 @@ namespace Reflect::Profile
 			static Instrumentor instance;
 			return instance;
 		}
+
 	private:
-		void WriteHeader()
+		/// <summary>
+		/// Marks code inside the profiler, allocations made while one is alive are not tracked. This also stops
+		/// RecordAllocation re-entering the profiler while it holds its locks.
+		/// </summary>
+		struct InternalScope
+		{
+			InternalScope() { ++InternalDepth(); }
+			~InternalScope() { --InternalDepth(); }
+		};
+
+		static int& InternalDepth()
 		{
-			m_dataString += "{\"otherData\": {},\"traceEvents\":[{}";
+			thread_local int depth = 0;
+			return depth;
 		}
 
-		void WriteFooter()
+		void Push(ProfileEventType type, const char* name, const char* category, int64_t start, int64_t value)
 		{
-			m_dataString += "]}";
+			if (!IsRecording())
+			{
+				return;
+			}
+			ThreadEventBuffer& buffer = GetThreadBuffer();
+			buffer.Push({ name, category, start, value, buffer.GetThreadId(), type });
 		}
 
-		// Note: you must already own lock on m_Mutex before
-		// calling InternalEndSession()
-		void InternalEndSession()
+		// Events are recorded in ProfileClock ticks, convert them before they are written out.
+		static ProfileEvent ToOutputEvent(const ProfileEvent& event)
 		{
-			if (m_CurrentSession)
+			ProfileEvent output = event;
+			output.Start = ProfileClock::ToNanoseconds(event.Start);
+			if (event.Type == ProfileEventType::Scope)
 			{
-				WriteFooter();
+				output.Value = ProfileClock::ToNanosecondsDuration(event.Value);
+			}
+			return output;
+		}
 
-				delete m_CurrentSession;
-				m_CurrentSession = nullptr;
+		void OnStateChanged(ProfileState state)
+		{
+			if (m_stateCallback)
+			{
+				m_stateCallback(state);
 			}
-			std::cout << "Logging has finished. Session: " << std::to_string(m_CurrentSession != nullptr) << std::endl;
 		}
+
+		// Note: you must already own lock on m_categoryMutex before calling IsCategoryInFilter().
+		bool IsCategoryInFilter(const std::string& name) const
+		{
+			return m_categoryFilter.empty() || std::find(m_categoryFilter.begin(), m_categoryFilter.end(), name) != m_categoryFilter.end();
+		}
+
+		template<typename Func>
+		void ForEachThreadName(Func&& func)
+		{
+			std::lock_guard lock(m_threadMutex);
+			for (auto& buffer : m_threadBuffers)
+			{
+				if (!buffer->GetName().empty())
+				{
+					func(buffer->GetThreadId(), buffer->GetName().c_str());
+				}
+			}
+		}
+
+		static ThreadEventBuffer& GetThreadBuffer()
+		{
+			// Plain pointer so the hot path has no thread_local initialisation guard. The registry owns
+			// the buffer, so events are not lost when the thread exits.
+			thread_local ThreadEventBuffer* buffer = nullptr;
+			if (buffer == nullptr)
+			{
+				buffer = Get().RegisterThread();
+			}
+			return *buffer;
+		}
+
+		ThreadEventBuffer* RegisterThread()
+		{
+			InternalScope internal;
+			std::lock_guard lock(m_threadMutex);
+			auto buffer = std::make_shared<ThreadEventBuffer>(m_nextThreadId++, DefaultThreadBufferCapacity, m_allocate, m_deallocate);
+			m_threadBuffers.push_back(buffer);
+			return buffer.get();
+		}
+
+		// Note: you must already own lock on m_Mutex before calling CollectEvents().
+		void CollectEvents()
+		{
+			if (m_streamThread.joinable())
+			{
+				// The writer thread owns the buffers while streaming.
+				return;
+			}
+
+			std::lock_guard lock(m_threadMutex);
+			for (auto& buffer : m_threadBuffers)
+			{
+				buffer->Drain([this](const ProfileEvent& event)
+					{
+						m_events.push_back(event);
+					});
+			}
+		}
+
+		// Note: you must already own lock on m_Mutex before calling ReleaseSavedEvents().
+		void ReleaseSavedEvents()
+		{
+			// Events before the oldest open session can't be saved by any session again, the rest are still needed.
+			if (m_openSessionStarts.empty())
+			{
+				std::vector<ProfileEvent>().swap(m_events);
+				return;
+			}
+			const int64_t oldestStart = *m_openSessionStarts.begin();
+			m_events.erase(std::remove_if(m_events.begin(), m_events.end(), [oldestStart](const ProfileEvent& event)
+				{
+					return event.Start < oldestStart;
+				}), m_events.end());
+		}
+
+		void StreamThread()
+		{
+			InternalScope internal;
+			std::string pending;
+			pending.reserve(m_streamOptions.MaxPendingBytes + 256);
+
+			auto writePending = [this, &pending]()
+			{
+				if (!pending.empty())
+				{
+					fwrite(pending.data(), 1, pending.size(), m_streamFile);
+					fflush(m_streamFile);
+					pending.clear();
+				}
+			};
+
+			std::vector<std::shared_ptr<ThreadEventBuffer>> buffers;
+			bool stop = false;
+			while (!stop)
+			{
+				{
+					std::unique_lock lock(m_streamMutex);
+					m_streamCondition.wait_for(lock, m_streamOptions.FlushInterval, [this]() { return m_streamStop; });
+					stop = m_streamStop;
+				}
+
+				{
+					// Only the buffer list and the names need the lock, the file is written without it so a thread
+					// recording its first scope (RegisterThread) never waits on the disk.
+					std::lock_guard lock(m_threadMutex);
+					buffers = m_threadBuffers;
+					for (auto& buffer : buffers)
+					{
+						if (!buffer->GetName().empty() && !buffer->IsNameWritten())
+						{
+							pending += m_streamEventCount++ == 0 ? "\n" : ",\n";
+							WriteThreadNameJson(pending, buffer->GetThreadId(), buffer->GetName().c_str());
+							buffer->SetNameWritten();
+						}
+					}
+				}
+
+				// This thread is the only one draining while streaming, the buffers are lock free for it.
+				for (auto& buffer : buffers)
+				{
+					buffer->Drain([&](const ProfileEvent& event)
+						{
+							if (event.Start < m_streamStart)
+							{
+								return;
+							}
+							pending += m_streamEventCount++ == 0 ? "\n" : ",\n";
+							WriteEventJson(pending, ToOutputEvent(event));
+							if (pending.size() >= m_streamOptions.MaxPendingBytes)
+							{
+								writePending();
+							}
+						});
+				}
+				writePending();
+			}
+		}
+
+		uint64_t GetDroppedCount()
+		{
+			std::lock_guard lock(m_threadMutex);
+			uint64_t dropped = 0;
+			for (auto& buffer : m_threadBuffers)
+			{
+				dropped += buffer->GetDroppedCount();
+			}
+			return dropped;
+		}
+
 	private:
 		std::mutex m_Mutex;
-		InstrumentationSession* m_CurrentSession;
-		std::ofstream m_OutputStream;
-		std::string m_dataString;
+		bool m_sessionActive;
+		int64_t m_sessionStart;
+		int64_t m_sessionEnd;
 
-		std::vector<Instrumentor*> m_profiles;
+		// Only used on Get().
+		std::atomic<uint32_t> m_activeSessions;
+		std::atomic<bool> m_enabled;
+		std::mutex m_threadMutex;
+		uint32_t m_nextThreadId;
+		std::vector<std::shared_ptr<ThreadEventBuffer>> m_threadBuffers;
+		// Collected by CollectEvents and released by ReleaseSavedEvents once saved.
+		std::vector<ProfileEvent> m_events;
+		// Start of every session which is open (guarded by m_Mutex).
+		std::multiset<int64_t> m_openSessionStarts;
+		std::mutex m_categoryMutex;
+		std::vector<std::unique_ptr<ProfileCategory>> m_categories;
+		std::vector<std::string> m_categoryFilter;
+		StateChangedCallback m_stateCallback;
+		AllocateFunc m_allocate;
+		DeallocateFunc m_deallocate;
+		MemoryCallback m_memoryCallback;
+		std::atomic<int64_t> m_liveBytes;
+		std::atomic<int64_t> m_peakBytes;
+		std::atomic<int64_t> m_reportedBytes;
+
+		// Streaming session, only used on Get().
+		FILE* m_streamFile;
+		StreamingOptions m_streamOptions;
+		int64_t m_streamStart;
+		uint64_t m_streamEventCount;
+		std::thread m_streamThread;
+		std::mutex m_streamMutex;
+		std::condition_variable m_streamCondition;
+		bool m_streamStop;
 	};
 
 	class InstrumentationTimer
 	{
 	public:
-		InstrumentationTimer(const char* name)
-			: m_Name(name), m_Stopped(false)
+		/// <summary>
+		/// 'name' is not copied, it must outlive the profile session (string literal or static).
+		/// </summary>
+		InstrumentationTimer(const char* name, const ProfileCategory* category = nullptr)
+			: m_Name(name)
+			, m_Category(category ? category->Name.c_str() : nullptr)
+			, m_Enabled(category == nullptr || category->Enabled.load(std::memory_order_relaxed))
+			, m_Stopped(false)
 		{
 			m_StartTimepoint = std::chrono::steady_clock::now();
+			m_StartTicks = ProfileClock::Now();
 		}
 
 		~InstrumentationTimer()
@@ -185,20 +893,58 @@ namespace Reflect::Profile
 		void Stop()
 		{
 			m_StopTimepoint = std::chrono::steady_clock::now();
-			auto highResStart = FloatingPointMicroseconds{ m_StartTimepoint.time_since_epoch() };
-			auto elapsedTime = std::chrono::time_point_cast<std::chrono::microseconds>(m_StopTimepoint).time_since_epoch() - std::chrono::time_point_cast<std::chrono::microseconds>(m_StartTimepoint).time_since_epoch();
-
-			Instrumentor::Get().WriteProfile({ m_Name, highResStart, elapsedTime, std::this_thread::get_id() });
+			if (m_Enabled)
+			{
+				Instrumentor::Get().WriteEvent(m_Name, m_StartTicks, ProfileClock::Now() - m_StartTicks, m_Category);
+			}
 
 			m_Stopped = true;
 		}
 	private:
 		const char* m_Name;
+		const char* m_Category;
+		bool m_Enabled;
+		int64_t m_StartTicks;
 		std::chrono::time_point<std::chrono::steady_clock> m_StartTimepoint;
 		std::chrono::time_point<std::chrono::steady_clock> m_StopTimepoint;
 		bool m_Stopped;
 	};
 
+	/// <summary>
+	/// Scope timer used by the REFLECT_PROFILE_* macros. Only reads the clock when a session is recording.
+	/// </summary>
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name, const ProfileCategory* category = nullptr)
+			: m_name(name)
+			, m_category(nullptr)
+			, m_start(-1)
+		{
+			if (Instrumentor::Get().IsRecording() && (category == nullptr || category->Enabled.load(std::memory_order_relaxed)))
+			{
+				m_category = category ? category->Name.c_str() : nullptr;
+				m_start = ProfileClock::Now();
+			}
+		}
+
+		~ProfileScope()
+		{
+			if (m_start >= 0)
+			{
+				Instrumentor::Get().WriteEvent(m_name, m_start, ProfileClock::Now() - m_start, m_category);
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_name;
+		const char* m_category;
+		int64_t m_start;
+	};
+
 	namespace InstrumentorUtils
 	{
 
@@ -230,22 +976,38 @@ namespace Reflect::Profile
 	}
 }
 
-#if  defined(DEBUG)
+// Profiling is compiled into Debug builds. Define REFLECT_PROFILE_RELEASE to also compile it into optimised builds.
+#if defined(DEBUG) || defined(REFLECT_PROFILE_RELEASE)
+#define REFLECT_PROFILE_ENABLED
+#endif
+
+#if defined(REFLECT_PROFILE_ENABLED)
 #define REFLECT_PROFILE_BEGIN_SESSION() Reflect::Profile::Instrumentor::Get().BeginSession()
 #define REFLECT_PROFILE_END_SESSION() Reflect::Profile::Instrumentor::Get().EndSession()
 #define REFLECT_PROFILE_SAVE_SESSION(filePath) Reflect::Profile::Instrumentor::Get().SaveSession(filePath)
-#define REFLECT_PROFILE_SCOPE_LINE2(name, line) constexpr auto fixedName##line = Reflect::Profile::InstrumentorUtils::CleanupOutputString(name, "__cdecl ");\
-											   Reflect::Profile::InstrumentationTimer timer##line(fixedName##line.Data)
+#define REFLECT_PROFILE_SAVE_SESSION_BINARY(filePath) Reflect::Profile::Instrumentor::Get().SaveSessionBinary(filePath)
+#define REFLECT_PROFILE_BEGIN_STREAMING_SESSION(filePath) Reflect::Profile::Instrumentor::Get().BeginStreamingSession(filePath)
+#define REFLECT_PROFILE_END_STREAMING_SESSION() Reflect::Profile::Instrumentor::Get().EndStreamingSession()
+#define REFLECT_PROFILE_SCOPE_LINE2(name, line) static constexpr auto fixedName##line = Reflect::Profile::InstrumentorUtils::CleanupOutputString(name, "__cdecl ");\
+											   Reflect::Profile::ProfileScope timer##line(fixedName##line.Data)
+#define REFLECT_PROFILE_CATEGORY_LINE2(name, category, line) static Reflect::Profile::ProfileCategory* profileCategory##line = Reflect::Profile::Instrumentor::Get().GetCategory(category);\
+											   Reflect::Profile::ProfileScope timer##line(name, profileCategory##line)
 
 #define REFLECT_PROFILE_FRAME(name) REFLECT_PROFILE_SCOPE(name)
 #define REFLECT_PROFILE_SCOPE_LINE(name, line) REFLECT_PROFILE_SCOPE_LINE2(name, line)
 #define REFLECT_PROFILE_SCOPE(name) REFLECT_PROFILE_SCOPE_LINE(name, __LINE__)
 #define REFLECT_PROFILE_FUNCTION() REFLECT_PROFILE_SCOPE(FUNC_SIG)
-#define REFLECT_PROFILE_CATEGORY(name, category) 
-#define REFLECT_PROFILE_THREAD(threadName)
-#define REFLECT_PROFILE_TAG(name, ptr)
-#define REFLECT_PROFILE_STATE_CHANGED(callbackFunc)
-#define REFLECT_PROFILE_SET_MEMORY_ALLOCATOR(allocFunc, deAllocFunc, callbackFunc)
+#define REFLECT_PROFILE_CATEGORY_LINE(name, category, line) REFLECT_PROFILE_CATEGORY_LINE2(name, category, line)
+#define REFLECT_PROFILE_CATEGORY(name, category) REFLECT_PROFILE_CATEGORY_LINE(name, category, __LINE__)
+#define REFLECT_PROFILE_SET_ENABLED(enabled) Reflect::Profile::Instrumentor::Get().SetEnabled(enabled)
+#define REFLECT_PROFILE_SET_CATEGORY_FILTER(filter) Reflect::Profile::Instrumentor::Get().SetCategoryFilter(filter)
+#define REFLECT_PROFILE_THREAD(threadName) Reflect::Profile::Instrumentor::Get().SetThreadName(threadName)
+#define REFLECT_PROFILE_TAG(name, value) Reflect::Profile::Instrumentor::Get().WriteInstant(name, static_cast<int64_t>(value))
+#define REFLECT_PROFILE_COUNTER(name, value) Reflect::Profile::Instrumentor::Get().WriteCounter(name, static_cast<int64_t>(value))
+#define REFLECT_PROFILE_STATE_CHANGED(callbackFunc) Reflect::Profile::Instrumentor::Get().SetStateChangedCallback(callbackFunc)
+#define REFLECT_PROFILE_SET_MEMORY_ALLOCATOR(allocFunc, deAllocFunc, callbackFunc) Reflect::Profile::Instrumentor::Get().SetMemoryAllocator(allocFunc, deAllocFunc, callbackFunc)
+#define REFLECT_PROFILE_ALLOCATION(size) Reflect::Profile::Instrumentor::Get().RecordAllocation(static_cast<int64_t>(size))
+#define REFLECT_PROFILE_DEALLOCATION(size) Reflect::Profile::Instrumentor::Get().RecordAllocation(-static_cast<int64_t>(size))
 
 #define REFLECT_PROFILE_START_CAPTURE() ::Reflect::Profile::Instrumentor temp; temp.BeginSession()
 #define REFLECT_PROFILE_STOP_CAPTURE() temp.EndSession()
@@ -255,13 +1017,21 @@ namespace Reflect::Profile
 #define REFLECT_PROFILE_BEGIN_SESSION()
 #define REFLECT_PROFILE_END_SESSION()
 #define REFLECT_PROFILE_SAVE_SESSION(filePath)
+#define REFLECT_PROFILE_SAVE_SESSION_BINARY(filePath)
+#define REFLECT_PROFILE_BEGIN_STREAMING_SESSION(filePath)
+#define REFLECT_PROFILE_END_STREAMING_SESSION()
 #define REFLECT_PROFILE_SCOPE(name)
 #define REFLECT_PROFILE_FUNCTION()
 #define REFLECT_PROFILE_CATEGORY(name, category)
+#define REFLECT_PROFILE_SET_ENABLED(enabled)
+#define REFLECT_PROFILE_SET_CATEGORY_FILTER(filter)
 #define REFLECT_PROFILE_THREAD(threadName)
-#define REFLECT_PROFILE_TAG(name, ptr)
+#define REFLECT_PROFILE_TAG(name, value)
+#define REFLECT_PROFILE_COUNTER(name, value)
 #define REFLECT_PROFILE_STATE_CHANGED(callbackFunc)
 #define REFLECT_PROFILE_SET_MEMORY_ALLOCATOR(allocFunc, deAllocFunc, callbackFunc)
+#define REFLECT_PROFILE_ALLOCATION(size)
+#define REFLECT_PROFILE_DEALLOCATION(size)
 
 #define REFLECT_PROFILE_START_CAPTURE()
 #define REFLECT_PROFILE_STOP_CAPTURE()
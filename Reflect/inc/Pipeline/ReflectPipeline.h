@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "ReflectStructs.h"
+#include "CodeGenerate/CodeGenerate.h"
+#include <string>
+#include <vector>
+
+namespace Reflect
+{
+	class FileParser;
+
+	/// <summary>
+	/// ReflectEXE's run over a set of headers. Each header is parsed, its bases resolved (InheritanceResolver) and its
+	/// code generated and written in one go, so a file is written as soon as it is ready. With parallel=true every header
+	/// is one task on a ThreadPool, otherwise they are done one after another. Then the unity files, the depfile manifest
+	/// and the reflection database are written. incremental, depfile, unity_files and database are all handled here.
+	/// </summary>
+	class ReflectPipeline
+	{
+	public:
+		/// <summary>
+		/// 'parser' has its ignore strings set already, the options are set on it here.
+		/// </summary>
+		REFLECT_API ReflectPipeline(FileParser& parser, const ReflectAddtionalOptions& addtionalOptions);
+		REFLECT_API ~ReflectPipeline();
+
+		/// <summary>
+		/// Reflect 'headerPaths'. A path must only be in the list once. Returns false, without writing anything,
+		/// if the options can't be used together (CheckOptions).
+		/// </summary>
+		REFLECT_API bool Run(const std::vector<std::string>& headerPaths);
+
+		/// <summary>
+		/// Log an error and return false if the options can't be used together. unity_files can't be used with
+		/// file_list: the unity files of a directory would only get the listed headers, and the generated code of
+		/// the other headers in it would be lost.
+		/// </summary>
+		REFLECT_API static bool CheckOptions(const ReflectAddtionalOptions& addtionalOptions);
+
+		/// <summary>
+		/// Headers skipped by incremental in the last Run.
+		/// </summary>
+		size_t GetSkippedFileCount() const { return m_skippedFileCount; }
+		/// <summary>
+		/// Time the last Run spent writing the reflection database, in nanoseconds.
+		/// </summary>
+		int64_t GetDatabaseWriteTime() const { return m_databaseWriteTime; }
+
+	private:
+		FileParser& m_parser;
+		ReflectAddtionalOptions m_options;
+		CodeGenerate m_codeGenerate;
+
+		size_t m_skippedFileCount = 0;
+		int64_t m_databaseWriteTime = 0;
+	};
+}
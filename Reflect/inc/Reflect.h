@@ -3,9 +3,19 @@
 #include "Core/Core.h"
 #include "Core/Enums.h"
 #include "Core/Util.h"
+#include "Core/Hash.h"
+#include "Core/TypeRegistry.h"
+#include "Core/StaticReflect.h"
+#include "Core/ReflectStatic.h"
+#include "Core/RunStats.h"
+#include "Core/ThreadPool.h"
 
 #include "FileParser/FileParser.h"
+#include "FileParser/HeaderCache.h"
+#include "FileParser/InheritanceResolver.h"
 #include "CodeGenerate/CodeGenerate.h"
+#include "Database/ReflectDatabase.h"
+#include "Pipeline/ReflectPipeline.h"
 
 #include "Instrumentor.h"
 #include "ReflectStructs.h"
\ No newline at end of file
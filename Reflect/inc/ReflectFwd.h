@@ -0,0 +1,81 @@
+#pragma once
+
+// Everything a reflected header and its generated header need, and nothing more.
+// Include this (instead of Reflect.h) in headers with REFLECT_STRUCT/REFLECT_CLASS so the
+// runtime (ReflectStructs.h, Core/Util.h, Log.h, ...) is only compiled by the .cpp files which use it.
+
+#include "Core/StaticReflect.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef REFLECT_DLL_EXPORT
+#define REFLECT_API __declspec(dllexport)
+#elif defined (REFLECT_DLL_IMPORT)
+#define REFLECT_API __declspec(dllimport)
+#else
+#define REFLECT_API
+#endif
+
+#define REFLECT_PROPERTY(...)
+#define NO_REFLECT(x) x
+
+#define BODY_MACRO_COMBINE_INNER(A, B, C, D) A##B##C##D
+#define BODY_MACRO_COMBINE(A, B, C, D) BODY_MACRO_COMBINE_INNER(A, B, C, D)
+
+#define REFLECT_GENERATED_BODY(...) BODY_MACRO_COMBINE(CURRENT_FILE_ID, _, __LINE__, _GENERATED_BODY);
+#define REFLECT_CPP_INCLUDE(...)
+
+#define REFLECT_BASE() public Reflect::IReflect
+#define REFLECT_STRUCT(...)
+#define REFLECT_CLASS(...)
+
+namespace Reflect
+{
+	enum class EReflectReturnCode;
+
+	class TypeInfo;
+	struct ReflectMember;
+	struct ReflectMemberProp;
+	struct ReflectFunction;
+	struct ReflectFunctionProp;
+	struct FunctionPtrArgs;
+
+	namespace Hash
+	{
+		/// <summary>
+		/// FNV-1a over a string. constexpr so it can be used for compile time ids.
+		/// </summary>
+		constexpr uint64_t HashString(std::string_view str)
+		{
+			uint64_t hash = 0xCBF29CE484222325ull;
+			for (char c : str)
+			{
+				hash ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
+				hash *= 0x100000001B3ull;
+			}
+			return hash;
+		}
+	}
+
+	using TypeId = uint64_t;
+
+	constexpr TypeId GetTypeId(std::string_view typeName)
+	{
+		return Hash::HashString(typeName);
+	}
+
+	/// <summary>
+	/// Base of every reflected class/struct (REFLECT_BASE()). The generated code overrides these.
+	/// </summary>
+	struct REFLECT_API IReflect
+	{
+		virtual ReflectFunction GetFunction(const char* functionName);
+		virtual ReflectMember GetMember(const char* memberName);
+		virtual std::vector<ReflectMember> GetMembers(std::vector<std::string> const& flags);
+		virtual std::vector<ReflectMember> GetAllMembers();
+		virtual const TypeInfo* GetTypeInfo() const { return nullptr; }
+	};
+}
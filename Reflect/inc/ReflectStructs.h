@@ -3,6 +3,9 @@
 #include "Core/Core.h"
 #include "Core/Enums.h"
 #include "Core/Util.h"
+#include "Core/StringInterner.h"
+#include "Core/Allocator.h"
+#include <memory>
 #include <vector>
 #include <functional>
 #include <type_traits>
@@ -115,20 +118,37 @@ namespace Reflect
 
 	};
 
+	/// <summary>
+	/// Vector of the parsed model. FileParser allocates them from the arena of the file they are parsed from
+	/// (FileParsedData::Arena), a copy of one uses the heap.
+	/// </summary>
+	template<typename T>
+	using ModelVector = std::vector<T, ArenaStdAllocator<T>>;
+
 	struct ReflectTypeNameData
 	{
-		std::string Type;
-		std::string Name;
+		// Names, types and flags are interned, the same few types and flags are used by every file.
+		InternedString Type;
+		InternedString Name;
 		EReflectValueType ReflectValueType;
 		EReflectValueModifier ReflectModifier;
-		std::vector<std::string> ContainerProps;
+		ModelVector<InternedString> ContainerProps;
 
 		int TypeSize;
 		bool IsConst;
 
 		ReflectTypeNameData()
-			: Type("")
-			, Name("")
+			: ReflectValueType(EReflectValueType::Value)
+			, ReflectModifier(EReflectValueModifier::None)
+
+			, TypeSize(0)
+			, IsConst(false)
+		{ }
+
+		explicit ReflectTypeNameData(ArenaAllocator* arena)
+			: ReflectValueType(EReflectValueType::Value)
+			, ReflectModifier(EReflectValueModifier::None)
+			, ContainerProps(arena)
 
 			, TypeSize(0)
 			, IsConst(false)
@@ -143,60 +163,100 @@ namespace Reflect
 			, IsConst(isConst)
 		{ }
 
+		bool ContainsProperty(std::string_view flag) const
+		{
+			return std::find(ContainerProps.begin(), ContainerProps.end(), flag) != ContainerProps.end();
+		}
+
 		bool operator!=(const ReflectTypeNameData& other) const
 		{
-			bool propsEqual = ContainerProps.size() != other.ContainerProps.size();
-			if (propsEqual)
-			{
-				for (uint32_t i = 0; i < ContainerProps.size(); ++i)
-				{
-					if (ContainerProps[i] == other.ContainerProps[i])
-					{
-						propsEqual = false;
-						break;
-					}
-				}
-			}
+			// Interned strings compare by pointer.
 			return Type != other.Type ||
 				Name != other.Name ||
 				TypeSize != other.TypeSize ||
-				propsEqual;
+				ContainerProps != other.ContainerProps;
 		}
 	};
 
 	struct ReflectMemberData : public ReflectTypeNameData
 	{
+		using ReflectTypeNameData::ReflectTypeNameData;
+
 		EReflectType ReflectType = EReflectType::Member;
 	};
 
 	struct ReflectFunctionData : public ReflectTypeNameData
 	{
+		ReflectFunctionData() = default;
+		explicit ReflectFunctionData(ArenaAllocator* arena)
+			: ReflectTypeNameData(arena)
+			, Parameters(arena)
+		{ }
+
 		EReflectType ReflectType = EReflectType::Function;
-		std::vector<ReflectTypeNameData> Parameters;
+		ModelVector<ReflectTypeNameData> Parameters;
+	};
+
+	/// <summary>
+	/// A reflected base of a container and the members/functions it declares. Found by InheritanceResolver.
+	/// </summary>
+	struct ReflectBaseData
+	{
+		InternedString Name;
+		// Path of the header the base is in.
+		std::string FilePath;
+		ModelVector<ReflectMemberData> Members;
+		ModelVector<ReflectFunctionData> Functions;
 	};
 
 	struct ReflectContainerData : public ReflectTypeNameData
 	{
-		std::string Name;
-		std::string PrettyName;
-		std::vector<std::string> Inheritance;
-		EReflectType ReflectType;
-		int ReflectGenerateBodyLine;
-
-		std::vector<ReflectMemberData> Members;
-		std::vector<ReflectFunctionData> Functions;
+		ReflectContainerData() = default;
+		explicit ReflectContainerData(ArenaAllocator* arena)
+			: ReflectTypeNameData(arena)
+			, Inheritance(arena)
+			, InheritanceAccess(arena)
+			, Members(arena)
+			, Functions(arena)
+		{ }
+
+		InternedString Name;
+		InternedString PrettyName;
+		ModelVector<InternedString> Inheritance;
+		// Access of each entry in Inheritance. Without a specifier a class inherits privately and a struct publicly.
+		ModelVector<EReflectAccess> InheritanceAccess;
+		EReflectType ReflectType = EReflectType::Unknown;
+		int ReflectGenerateBodyLine = 0;
+
+		ModelVector<ReflectMemberData> Members;
+		ModelVector<ReflectFunctionData> Functions;
+
+		// Every reflected base, direct or not, each one before the bases which derive from it. Only set by
+		// InheritanceResolver when the whole hierarchy is reflected, the generated code then has flattened tables.
+		// Always on the heap, it is set after the file is parsed.
+		std::vector<ReflectBaseData> ResolvedBases;
 	};
 
 	struct FileParsedData
 	{
+		// Every container, member and function parsed from the file is allocated from here, so the model is built
+		// with a few large allocations and released in one go with the last FileParsedData sharing it. Moving
+		// FileParsedData keeps the arena with the model, a copy of the model uses the heap.
+		std::shared_ptr<ArenaAllocator> Arena;
+
 		std::string Data;
 		int Cursor;
 		std::string FilePath;
 		std::string FileName;
+		// Extension of the source file including the '.' (".h" or ".hpp").
+		std::string FileExtension;
 		int GeneratedBodyLineOffset;
 		std::vector<std::string> CPPIncludes;
+		// Headers this one includes, directly or not, which the bases were looked for in. Set by InheritanceResolver,
+		// they are dependencies of the generated files.
+		std::vector<std::string> IncludedHeaders;
 
-		std::vector<ReflectContainerData> ReflectData;
+		ModelVector<ReflectContainerData> ReflectData;
 	};
 
 	struct ReflectMemberProp
@@ -276,6 +336,33 @@ namespace Reflect
 
 	using FunctionPtr = Reflect::EReflectReturnCode(*)(void* objectPtr, void* returnValue, FunctionPtrArgs& args);
 
+	struct ReflectFunctionProp
+	{
+		ReflectFunctionProp(const char* name, FunctionPtr func, size_t offset = 0)
+			: Name(name)
+			, Func(func)
+			, Offset(offset)
+		{ }
+
+		const char* Name;
+		FunctionPtr Func;
+		// Offset from the start of the object to pass to Func. Not 0 for functions inherited from a base
+		// which isn't at the start of the object (TypeInfo::GetAllFunctions).
+		size_t Offset;
+	};
+
+	/// <summary>
+	/// Offset of the 'Base' part of a 'Derived' object. The inherited entries of the flattened
+	/// member/function tables are moved by this. Only works for non virtual bases.
+	/// </summary>
+	template<typename Derived, typename Base>
+	size_t BaseOffset()
+	{
+		// Nothing is dereferenced and only the difference is used, so any aligned non null address will do.
+		constexpr uintptr_t address = 0x1000;
+		return static_cast<size_t>(reinterpret_cast<uintptr_t>(static_cast<Base*>(reinterpret_cast<Derived*>(address))) - address);
+	}
+
 	struct ReflectFunction
 	{
 		ReflectFunction(void* objectPtr, FunctionPtr func)
@@ -376,15 +463,4 @@ namespace Reflect
 		int m_offset;
 	};
 
-	struct REFLECT_API IReflect
-	{
-		virtual ReflectFunction GetFunction(const char* functionName) { (void)functionName; return ReflectFunction(nullptr, nullptr);};
-		virtual ReflectMember GetMember(const char* memberName) { (void)memberName; return ReflectMember("", nullptr, nullptr); };
-		virtual std::vector<ReflectMember> GetMembers(std::vector<std::string> const& flags) { (void)flags; return {}; };
-		virtual std::vector<ReflectMember> GetAllMembers() { return {}; };
-	};
 }
-
-#define REFLECT_BASE() public Reflect::IReflect
-#define REFLECT_STRUCT(...)
-#define REFLECT_CLASS(...)
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace Reflect::Profile
+{
+	enum class ProfileEventType : uint8_t
+	{
+		// Timed scope, 'Duration' is in nanoseconds.
+		Scope,
+		// Single point in time, 'Value' is attached to the event.
+		Instant,
+		// New value for the counter track 'Name'.
+		Counter,
+	};
+
+	/// <summary>
+	/// Fixed size binary event recorded on the hot path. Converted to text only when the session is saved.
+	/// 'Name' and 'Category' are not copied so they must point to strings with static storage duration.
+	/// </summary>
+	struct ProfileEvent
+	{
+		const char* Name;
+		const char* Category;
+		int64_t Start;
+		// Duration for scopes, value for instant and counter events.
+		int64_t Value;
+		uint32_t ThreadId;
+		ProfileEventType Type;
+	};
+
+	inline void WriteJsonString(std::string& json, const char* str)
+	{
+		json += '"';
+		for (const char* c = str; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				json += '\\';
+			}
+			json += *c;
+		}
+		json += '"';
+	}
+
+	/// <summary>
+	/// Write a single event as a Chrome trace json object (no separator).
+	/// </summary>
+	inline void WriteEventJson(std::string& json, const ProfileEvent& event)
+	{
+		char buffer[96];
+		json += "{\"cat\":";
+		WriteJsonString(json, event.Category ? event.Category : "function");
+		json += ",\"name\":";
+		WriteJsonString(json, event.Name);
+		switch (event.Type)
+		{
+		case ProfileEventType::Scope:
+			snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"dur\":%.3f", event.Value / 1000.0);
+			break;
+		case ProfileEventType::Instant:
+			snprintf(buffer, sizeof(buffer), ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"value\":%lld}", static_cast<long long>(event.Value));
+			break;
+		case ProfileEventType::Counter:
+			snprintf(buffer, sizeof(buffer), ",\"ph\":\"C\",\"args\":{\"value\":%lld}", static_cast<long long>(event.Value));
+			break;
+		}
+		json += buffer;
+		snprintf(buffer, sizeof(buffer), ",\"pid\":0,\"tid\":%u,\"ts\":%.3f}", event.ThreadId, event.Start / 1000.0);
+		json += buffer;
+	}
+
+	/// <summary>
+	/// Write the metadata event which names the thread 'threadId' in the trace viewer.
+	/// </summary>
+	inline void WriteThreadNameJson(std::string& json, uint32_t threadId, const char* name)
+	{
+		char buffer[64];
+		json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,";
+		snprintf(buffer, sizeof(buffer), "\"tid\":%u,\"args\":{\"name\":", threadId);
+		json += buffer;
+		WriteJsonString(json, name);
+		json += "}}";
+	}
+
+	/// <summary>
+	/// Compact binary trace file written by Instrumentor::SaveSessionBinary and expanded back to json
+	/// by ReflectTraceConverter.
+	///
+	/// Layout: the header (magic + version) followed by a stream of records, each starting with a RecordType byte.
+	///		String:	 varint id, varint length, bytes. Defined before the first event using it.
+	///		Event:	 ProfileEventType byte, varint name id, varint category id + 1 (0 for none), varint thread id,
+	///				 zigzag varint start delta (from the previous event), zigzag varint duration/value.
+	///		Dropped: varint number of events dropped while recording.
+	///		Thread:	 varint thread id, varint name id.
+	/// All times are in nanoseconds.
+	/// </summary>
+	namespace TraceFormat
+	{
+		constexpr char Magic[4] = { 'R', 'T', 'R', 'C' };
+		constexpr uint8_t Version = 2;
+		constexpr const char* FileExtension = ".rtrace";
+
+		enum class RecordType : uint8_t
+		{
+			String = 1,
+			Event = 2,
+			Dropped = 3,
+			Thread = 4,
+		};
+
+		inline void WriteVarint(std::string& out, uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				out += static_cast<char>((value & 0x7F) | 0x80);
+				value >>= 7;
+			}
+			out += static_cast<char>(value);
+		}
+
+		inline bool ReadVarint(const char*& data, const char* end, uint64_t& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 64 && data < end; shift += 7)
+			{
+				uint8_t byte = static_cast<uint8_t>(*data++);
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		constexpr uint64_t ZigZagEncode(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+		constexpr int64_t ZigZagDecode(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+		/// <summary>
+		/// Encode events into the binary format. Scope names are compared by pointer, so each name
+		/// literal is only stored once.
+		/// </summary>
+		class Writer
+		{
+		public:
+			Writer()
+				: m_previousStart(0)
+			{
+				m_data.append(Magic, sizeof(Magic));
+				m_data += static_cast<char>(Version);
+			}
+
+			void WriteEvent(const ProfileEvent& event)
+			{
+				uint32_t nameId = GetStringId(event.Name);
+				uint32_t categoryId = event.Category ? GetStringId(event.Category) + 1 : 0;
+				m_data += static_cast<char>(RecordType::Event);
+				m_data += static_cast<char>(event.Type);
+				WriteVarint(m_data, nameId);
+				WriteVarint(m_data, categoryId);
+				WriteVarint(m_data, event.ThreadId);
+				WriteVarint(m_data, ZigZagEncode(event.Start - m_previousStart));
+				WriteVarint(m_data, ZigZagEncode(event.Value));
+				m_previousStart = event.Start;
+			}
+
+			void WriteThreadName(uint32_t threadId, const char* name)
+			{
+				uint32_t nameId = GetStringId(name);
+				m_data += static_cast<char>(RecordType::Thread);
+				WriteVarint(m_data, threadId);
+				WriteVarint(m_data, nameId);
+			}
+
+			void WriteDropped(uint64_t droppedCount)
+			{
+				m_data += static_cast<char>(RecordType::Dropped);
+				WriteVarint(m_data, droppedCount);
+			}
+
+			const std::string& GetData() const { return m_data; }
+
+		private:
+			uint32_t GetStringId(const char* name)
+			{
+				auto itr = m_strings.find(name);
+				if (itr != m_strings.end())
+				{
+					return itr->second;
+				}
+
+				uint32_t id = static_cast<uint32_t>(m_strings.size());
+				m_strings[name] = id;
+				size_t length = strlen(name);
+				m_data += static_cast<char>(RecordType::String);
+				WriteVarint(m_data, id);
+				WriteVarint(m_data, length);
+				m_data.append(name, length);
+				return id;
+			}
+
+		private:
+			std::string m_data;
+			std::unordered_map<const char*, uint32_t> m_strings;
+			int64_t m_previousStart;
+		};
+
+		/// <summary>
+		/// Decode a binary trace. The ProfileEvent names point into 'Strings' so the reader must
+		/// outlive the events.
+		/// </summary>
+		class Reader
+		{
+		public:
+			struct ThreadName
+			{
+				uint32_t ThreadId;
+				const char* Name;
+			};
+
+			bool Read(std::string_view data)
+			{
+				m_strings.clear();
+				m_events.clear();
+				m_threadNames.clear();
+				m_droppedCount = 0;
+
+				if (data.size() < sizeof(Magic) + 1 || memcmp(data.data(), Magic, sizeof(Magic)) != 0)
+				{
+					m_error = "Not a reflect trace file.";
+					return false;
+				}
+				if (static_cast<uint8_t>(data[sizeof(Magic)]) != Version)
+				{
+					m_error = "Unsupported trace version.";
+					return false;
+				}
+
+				// Names are resolved after reading as m_strings can reallocate.
+				std::vector<uint64_t> nameIds;
+				std::vector<uint64_t> categoryIds;
+				std::vector<uint64_t> threadNameIds;
+				const char* itr = data.data() + sizeof(Magic) + 1;
+				const char* end = data.data() + data.size();
+				int64_t previousStart = 0;
+				while (itr < end)
+				{
+					RecordType type = static_cast<RecordType>(*itr++);
+					uint64_t values[5];
+					switch (type)
+					{
+					case RecordType::String:
+						if (!ReadVarint(itr, end, values[0]) || !ReadVarint(itr, end, values[1])
+							|| values[0] != m_strings.size() || values[1] > static_cast<uint64_t>(end - itr))
+						{
+							m_error = "Corrupt string record.";
+							return false;
+						}
+						m_strings.emplace_back(itr, static_cast<size_t>(values[1]));
+						itr += values[1];
+						break;
+
+					case RecordType::Event:
+					{
+						if (itr == end || static_cast<uint8_t>(*itr) > static_cast<uint8_t>(ProfileEventType::Counter))
+						{
+							m_error = "Corrupt event record.";
+							return false;
+						}
+						ProfileEventType eventType = static_cast<ProfileEventType>(*itr++);
+						for (uint64_t& value : values)
+						{
+							if (!ReadVarint(itr, end, value))
+							{
+								m_error = "Corrupt event record.";
+								return false;
+							}
+						}
+						if (values[0] >= m_strings.size() || values[1] > m_strings.size())
+						{
+							m_error = "Event references an unknown string.";
+							return false;
+						}
+						previousStart += ZigZagDecode(values[3]);
+						nameIds.push_back(values[0]);
+						categoryIds.push_back(values[1]);
+						m_events.push_back({ nullptr, nullptr, previousStart, ZigZagDecode(values[4]), static_cast<uint32_t>(values[2]), eventType });
+						break;
+					}
+
+					case RecordType::Thread:
+						if (!ReadVarint(itr, end, values[0]) || !ReadVarint(itr, end, values[1]) || values[1] >= m_strings.size())
+						{
+							m_error = "Corrupt thread record.";
+							return false;
+						}
+						threadNameIds.push_back(values[1]);
+						m_threadNames.push_back({ static_cast<uint32_t>(values[0]), nullptr });
+						break;
+
+					case RecordType::Dropped:
+						if (!ReadVarint(itr, end, values[0]))
+						{
+							m_error = "Corrupt dropped record.";
+							return false;
+						}
+						m_droppedCount += values[0];
+						break;
+
+					default:
+						m_error = "Unknown record type.";
+						return false;
+					}
+				}
+
+				for (size_t i = 0; i < m_events.size(); ++i)
+				{
+					m_events[i].Name = m_strings[nameIds[i]].c_str();
+					m_events[i].Category = categoryIds[i] > 0 ? m_strings[categoryIds[i] - 1].c_str() : nullptr;
+				}
+				for (size_t i = 0; i < m_threadNames.size(); ++i)
+				{
+					m_threadNames[i].Name = m_strings[threadNameIds[i]].c_str();
+				}
+				return true;
+			}
+
+			const std::vector<std::string>& GetStrings() const { return m_strings; }
+			const std::vector<ProfileEvent>& GetEvents() const { return m_events; }
+			const std::vector<ThreadName>& GetThreadNames() const { return m_threadNames; }
+			uint64_t GetDroppedCount() const { return m_droppedCount; }
+			const std::string& GetError() const { return m_error; }
+
+		private:
+			std::vector<std::string> m_strings;
+			std::vector<ProfileEvent> m_events;
+			std::vector<ThreadName> m_threadNames;
+			uint64_t m_droppedCount = 0;
+			std::string m_error;
+		};
+	}
+}
@@ -0,0 +1,17 @@
+#include "CodeGenerate/CodeEmitter.h"
+#include <fstream>
+
+namespace Reflect
+{
+	bool CodeEmitter::WriteToFile(const std::string& filePath) const
+	{
+		std::ofstream file(filePath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		// A single write larger than the stream's buffer goes straight to the file.
+		file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		return file.good();
+	}
+}
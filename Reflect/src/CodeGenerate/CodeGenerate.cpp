@@ -1,9 +1,15 @@
 #include "CodeGenerate/CodeGenerate.h"
 #include "CodeGenerate/CodeGenerateHeader.h"
 #include "CodeGenerate/CodeGenerateSource.h"
+#include "Core/RunStats.h"
+#include "Core/Log.h"
 #include "Instrumentor.h"
+#include <algorithm>
 #include <assert.h>
+#include <stdlib.h>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
 
 namespace Reflect
 {
@@ -19,48 +25,312 @@ namespace Reflect
 	{
 		REFLECT_PROFILE_FUNCTION();
 
-		CodeGenerateHeader header;
-		CodeGenerateSource source;
+		const std::string statsName = data.FilePath + "/" + data.FileName;
 
+		// Most of the generated code is per member/function, so size the buffers up front from that.
+		size_t memberCount = 0;
+		size_t functionCount = 0;
+		for (const auto& reflectData : data.ReflectData)
+		{
+			memberCount += reflectData.Members.size();
+			functionCount += reflectData.Functions.size();
+		}
+		CodeEmitter headerEmitter(CodeEmitter::DefaultReserve + data.ReflectData.size() * 1024 + memberCount * 192 + functionCount * 512);
+		CodeEmitter sourceEmitter(CodeEmitter::DefaultReserve + data.ReflectData.size() * 2048 + memberCount * 192 + functionCount * 128);
+		{
+			// Generate into memory first so code generation and disk writes are timed separately.
+			ScopedPhaseTimer generateTimer(EReflectPhase::CodeGenerate, statsName);
+			CodeGenerateHeader header;
+			CodeGenerateSource source;
+			header.GenerateHeader(data, headerEmitter, addtionalOptions);
+			source.GenerateSource(data, sourceEmitter, addtionalOptions);
+		}
+
+		ScopedPhaseTimer writeTimer(EReflectPhase::Write, statsName);
 		if (!std::filesystem::exists(data.FilePath + "/Generated"))
 		{
 			std::filesystem::create_directory(data.FilePath + "/Generated");
 		}
 
-		std::ofstream file = OpenFile(data.FilePath + "/Generated/" + data.FileName + ReflectFileGeneratePrefix + ".h");
-		header.GenerateHeader(data, file, addtionalOptions);
-		CloseFile(file);
+		WriteFile(headerEmitter, GetGeneratedFilePath(data.FilePath, data.FileName, ".h"));
+		const std::string sourcePath = GetGeneratedFilePath(data.FilePath, data.FileName, ".cpp");
+		if (GetUnityFileCount(addtionalOptions) > 0)
+		{
+			// The code goes into the unity files, a .cpp left over from a previous run would define everything twice.
+			std::error_code err;
+			std::filesystem::remove(sourcePath, err);
+
+			std::lock_guard lock(m_unityMutex);
+			m_unitySources[data.FilePath].push_back({ data.FileName, sourceEmitter.Release() });
+		}
+		else
+		{
+			WriteFile(sourceEmitter, sourcePath);
+			RemoveStaleUnityFiles(data.FilePath + "/Generated/", 0);
+		}
+
+		if (!addtionalOptions.options.at(Reflect_CMD_Option_Depfile).empty())
+		{
+			// Written last so its time stamp says the generated files are complete (IsUpToDate).
+			WriteDepfile(data, addtionalOptions);
+		}
+	}
+
+	bool CodeGenerate::IsUpToDate(const std::string& headerPath, const std::vector<std::string>& includedHeaders, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		if (GetUnityFileCount(addtionalOptions) > 0)
+		{
+			return false;
+		}
+
+		const std::filesystem::path path(headerPath);
+		const std::string directory = path.parent_path().u8string();
+		const std::string fileName = path.stem().u8string();
+
+		std::error_code err;
+		std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(path, err);
+		if (err)
+		{
+			return false;
+		}
+		for (const std::string& includedHeader : includedHeaders)
+		{
+			const std::filesystem::file_time_type includeTime = std::filesystem::last_write_time(includedHeader, err);
+			if (err)
+			{
+				return false;
+			}
+			sourceTime = std::max(sourceTime, includeTime);
+		}
+
+		std::vector<const char*> extensions = { ".h", ".cpp" };
+		if (!addtionalOptions.options.at(Reflect_CMD_Option_Depfile).empty())
+		{
+			extensions.push_back(".d");
+		}
+		for (const char* extension : extensions)
+		{
+			const std::filesystem::file_time_type generatedTime = std::filesystem::last_write_time(GetGeneratedFilePath(directory, fileName, extension), err);
+			if (err || generatedTime < sourceTime)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void CodeGenerate::WriteDependencyManifest(const std::vector<std::string>& headerPaths, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		const std::string& manifestPath = addtionalOptions.options.at(Reflect_CMD_Option_Depfile);
+		if (manifestPath.empty())
+		{
+			return;
+		}
+
+		// Sorted so the manifest doesn't change between runs (or with parallel=true).
+		std::vector<std::string> sortedPaths = headerPaths;
+		std::sort(sortedPaths.begin(), sortedPaths.end());
+
+		CodeEmitter manifest;
+		for (const std::string& headerPath : sortedPaths)
+		{
+			const std::filesystem::path path(headerPath);
+			std::ifstream depfile(GetGeneratedFilePath(path.parent_path().u8string(), path.stem().u8string(), ".d"), std::ios::binary);
+			if (!depfile.is_open())
+			{
+				// Nothing to reflect in this header, so nothing is generated from it.
+				continue;
+			}
+			std::string data((std::istreambuf_iterator<char>(depfile)), std::istreambuf_iterator<char>());
+			manifest.Append(data);
+		}
+
+		if (!manifest.WriteToFile(manifestPath))
+		{
+			Log_Error("[CodeGenerate::WriteDependencyManifest] File '%s' could not be written.", manifestPath.c_str());
+		}
+	}
+
+	std::string CodeGenerate::GetGeneratedFilePath(const std::string& directory, const std::string& fileName, const char* extension)
+	{
+		return directory + "/Generated/" + fileName + ReflectFileGeneratePrefix + extension;
+	}
+
+	void CodeGenerate::WriteDepfile(const FileParsedData& data, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		// Make treats spaces, '#' and '$' as special, Ninja reads the same escapes.
+		auto writePath = [](CodeEmitter& file, const std::filesystem::path& path)
+		{
+			for (char c : path.generic_u8string())
+			{
+				if (c == ' ' || c == '#')
+				{
+					file.Append('\\');
+				}
+				else if (c == '$')
+				{
+					file.Append('$');
+				}
+				file.Append(c);
+			}
+		};
+
+		CodeEmitter file(1024);
+		writePath(file, GetGeneratedFilePath(data.FilePath, data.FileName, ".h"));
+		if (GetUnityFileCount(addtionalOptions) == 0)
+		{
+			file.Append(' ');
+			writePath(file, GetGeneratedFilePath(data.FilePath, data.FileName, ".cpp"));
+		}
+		file.Append(": ");
+		writePath(file, data.FilePath + "/" + data.FileName + data.FileExtension);
+
+		// REFLECT_CPP_INCLUDE headers are included by the generated .cpp, which looks next to itself first
+		// and then next to the source header. Ones found on neither path come from the include paths and are left out.
+		std::vector<std::string> includes;
+		std::vector<std::string> dependencies;
+		for (const std::string& include : data.CPPIncludes)
+		{
+			if (std::find(includes.begin(), includes.end(), include) != includes.end())
+			{
+				continue;
+			}
+			includes.push_back(include);
+
+			std::error_code err;
+			const std::filesystem::path candidates[] = { data.FilePath + "/Generated/" + include, data.FilePath + "/" + include };
+			bool found = false;
+			for (const std::filesystem::path& candidate : candidates)
+			{
+				if (std::filesystem::is_regular_file(candidate, err))
+				{
+					file.Append(" \\\n  ");
+					writePath(file, candidate.lexically_normal());
+					dependencies.push_back(candidate.lexically_normal().generic_u8string());
+					found = true;
+					break;
+				}
+			}
+			if (!found)
+			{
+				Log_Verbose("[CodeGenerate::WriteDepfile] '%s' included by '%s' was not found, it is not in the depfile.", include.c_str(), data.FileName.c_str());
+			}
+		}
+
+		// The bases are looked for in the included headers, so a change to any of them can change the flattened tables.
+		for (const std::string& includedHeader : data.IncludedHeaders)
+		{
+			if (std::find(dependencies.begin(), dependencies.end(), includedHeader) == dependencies.end())
+			{
+				file.Append(" \\\n  ");
+				writePath(file, includedHeader);
+			}
+		}
+		file.Append('\n');
+
+		WriteFile(file, GetGeneratedFilePath(data.FilePath, data.FileName, ".d"));
+	}
 
-		file = OpenFile(data.FilePath + "/Generated/" + data.FileName + ReflectFileGeneratePrefix + ".cpp");
-		source.GenerateSource(data, file, addtionalOptions);
-		CloseFile(file);
+	void CodeGenerate::WriteUnityFiles(const ReflectAddtionalOptions& addtionalOptions)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		const size_t unityFileCount = GetUnityFileCount(addtionalOptions);
+		if (unityFileCount == 0)
+		{
+			return;
+		}
+
+		std::unordered_map<std::string, std::vector<UnitySource>> unitySources;
+		{
+			std::lock_guard lock(m_unityMutex);
+			unitySources.swap(m_unitySources);
+		}
+
+		const int64_t writeStart = RunStats::Now();
+		for (auto& [directory, sources] : unitySources)
+		{
+			// Files can arrive in any order when running in parallel, sort them so the output is always the same.
+			std::sort(sources.begin(), sources.end(), [](const UnitySource& a, const UnitySource& b)
+				{
+					return a.FileName < b.FileName;
+				});
+
+			const std::string generatedDirectory = directory + "/Generated/";
+			const size_t fileCount = std::min(unityFileCount, sources.size());
+			for (size_t i = 0; i < fileCount; ++i)
+			{
+				const size_t begin = sources.size() * i / fileCount;
+				const size_t end = sources.size() * (i + 1) / fileCount;
+
+				size_t size = 0;
+				for (size_t j = begin; j < end; ++j)
+				{
+					size += sources[j].Source.size();
+				}
+
+				CodeEmitter file(size + 1024);
+				file.Append(" // This file is auto generated by the Reflect tool please don't modify this file as it will be overwritten.\n");
+				if (!addtionalOptions.options.at(Reflect_CMD_Option_PCH_Include).empty())
+				{
+					IncludeHeader(addtionalOptions.options.at(Reflect_CMD_Option_PCH_Include), file);
+				}
+				for (size_t j = begin; j < end; ++j)
+				{
+					file.Append("\n// ", sources[j].FileName, ".h\n");
+					file.Append(sources[j].Source);
+				}
+				WriteFile(file, generatedDirectory + ReflectUnityFilePrefix + std::to_string(i) + ReflectFileGeneratePrefix + ".cpp");
+			}
+			RemoveStaleUnityFiles(generatedDirectory, fileCount);
+		}
+		RunStats::Get().AddPhaseTime(EReflectPhase::Write, RunStats::Now() - writeStart);
+	}
+
+	size_t CodeGenerate::GetUnityFileCount(const ReflectAddtionalOptions& addtionalOptions)
+	{
+		auto itr = addtionalOptions.options.find(Reflect_CMD_Option_Unity_Files);
+		if (itr == addtionalOptions.options.end())
+		{
+			return 0;
+		}
+		const long count = strtol(itr->second.c_str(), nullptr, 10);
+		return count > 0 ? static_cast<size_t>(count) : 0;
 	}
 
-	std::ofstream CodeGenerate::OpenFile(const std::string& filePath)
+	void CodeGenerate::RemoveStaleUnityFiles(const std::string& generatedDirectory, size_t unityFileCount)
 	{
-		std::ofstream file;
-		file.open(filePath, std::ios::trunc);
-		assert(file.is_open() && "[CodeGenerate::OpenFile] File could not be created.");
-		return file;
+		// A previous run with a larger (or any) unity_files leaves files behind which would define everything twice.
+		for (size_t i = unityFileCount; ; ++i)
+		{
+			std::error_code err;
+			if (!std::filesystem::remove(generatedDirectory + ReflectUnityFilePrefix + std::to_string(i) + ReflectFileGeneratePrefix + ".cpp", err))
+			{
+				break;
+			}
+		}
 	}
 
-	void CodeGenerate::CloseFile(std::ofstream& file)
+	void CodeGenerate::WriteFile(const CodeEmitter& emitter, const std::string& filePath)
 	{
-		if (file.is_open())
+		if (!emitter.WriteToFile(filePath))
 		{
-			file.close();
+			Log_Error("[CodeGenerate::WriteFile] File '%s' could not be written.", filePath.c_str());
+			assert(false && "[CodeGenerate::WriteFile] File could not be written.");
 		}
 	}
 
-	void CodeGenerate::IncludeHeader(const std::string& headerToInclude, std::ofstream& file, bool windowsInclude)
+	void CodeGenerate::IncludeHeader(const std::string& headerToInclude, CodeEmitter& file, bool windowsInclude)
 	{
 		if (windowsInclude)
 		{
-			file << "#include <" + headerToInclude + ">\n";
+			file.Append("#include <", headerToInclude, ">\n");
 		}
 		else
 		{
-			file << "#include \"" + headerToInclude + "\"\n";
+			file.Append("#include \"", headerToInclude, "\"\n");
 		}
 	}
 }
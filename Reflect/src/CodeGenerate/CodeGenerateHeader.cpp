@@ -10,31 +10,31 @@ namespace Reflect
 		return  fileName + "_Source_h";
 	}
 
-#define WRITE_CURRENT_FILE_ID(FileName) file << "#define " + GetCurrentFileID(FileName)
-#define WRITE_CLOSE() file << "\n\n"
+#define WRITE_CLOSE() file.Append("\n\n")
 
-#define WRITE_PUBLIC() file << "public:\\\n"
-#define WRITE_PRIVATE() file << "private:\\\n"
+#define WRITE_PUBLIC() file.Append("public:\\\n")
+#define WRITE_PRIVATE() file.Append("private:\\\n")
+#define WRITE_PROTECTED() file.Append("protected:\\\n")
 
-	void CodeGenerateHeader::GenerateHeader(const FileParsedData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateHeader::GenerateHeader(const FileParsedData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
 	{
 		REFLECT_PROFILE_FUNCTION();
 
-		file << " // This file is auto generated by the Reflect tool please don't modify this file as it will be overwritten.\n";
+		file.Append(" // This file is auto generated by the Reflect tool please don't modify this file as it will be overwritten.\n");
 
-		CodeGenerate::IncludeHeader("ReflectStructs.h", file);
-		CodeGenerate::IncludeHeader("Core/Util.h", file);
+		// Only the forward declarations, the runtime is included by the generated .cpp.
+		CodeGenerate::IncludeHeader("ReflectFwd.h", file);
 
-		file << "\n";
-		file << "#ifdef " + data.FileName + ReflectFileGeneratePrefix + "_h\n";
-		file << "#error \"" + data.FileName + ReflectFileGeneratePrefix + ".h" + " already included, missing 'pragma once' in " + data.FileName + ".h\"\n";
-		file << "#endif " + data.FileName + ReflectFileGeneratePrefix + "_h\n";
-		file << "#define " + data.FileName + ReflectFileGeneratePrefix + "_h\n\n";
+		file.Append("\n");
+		file.Append("#ifdef ", data.FileName, ReflectFileGeneratePrefix, "_h\n");
+		file.Append("#error \"", data.FileName, ReflectFileGeneratePrefix, ".h already included, missing 'pragma once' in ", data.FileName, ".h\"\n");
+		file.Append("#endif ", data.FileName, ReflectFileGeneratePrefix, "_h\n");
+		file.Append("#define ", data.FileName, ReflectFileGeneratePrefix, "_h\n\n");
 
 		WriteMacros(data, file, addtionalOptions);
 	}
 
-	void CodeGenerateHeader::WriteMacros(const FileParsedData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateHeader::WriteMacros(const FileParsedData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
 	{
 		for (const auto& reflectData : data.ReflectData)
 		{
@@ -45,134 +45,196 @@ namespace Reflect
 			WriteFunctionGet(reflectData, file, CurrentFileId, addtionalOptions);
 			WriteMemberPropertiesOffsets(reflectData, file, CurrentFileId, addtionalOptions);
 			WriteMemberGet(reflectData, file, CurrentFileId, addtionalOptions);
-
-			WRITE_CURRENT_FILE_ID(data.FileName) + "_" + std::to_string(reflectData.ReflectGenerateBodyLine) + "_GENERATED_BODY \\\n";
-			file << CurrentFileId + "_PROPERTIES \\\n";
-			file << CurrentFileId + "_FUNCTION_DECLARE \\\n";
-			file << CurrentFileId + "_FUNCTION_GET \\\n";
-			file << CurrentFileId + "_PROPERTIES_OFFSET \\\n";
-			file << CurrentFileId + "_PROPERTIES_GET \\\n";
+			WriteHash(reflectData, file, CurrentFileId, addtionalOptions);
+			WriteTypeInfo(reflectData, file, CurrentFileId, addtionalOptions);
+			WriteStaticClass(reflectData, file, CurrentFileId, addtionalOptions);
+
+			file.Append("#define ", CurrentFileId, "_GENERATED_BODY \\\n");
+			file.Append(CurrentFileId, "_PROPERTIES \\\n");
+			file.Append(CurrentFileId, "_FUNCTION_DECLARE \\\n");
+			file.Append(CurrentFileId, "_FUNCTION_GET \\\n");
+			file.Append(CurrentFileId, "_PROPERTIES_OFFSET \\\n");
+			file.Append(CurrentFileId, "_PROPERTIES_GET \\\n");
+			file.Append(CurrentFileId, "_HASH \\\n");
+			file.Append(CurrentFileId, "_TYPE_INFO \\\n");
+			file.Append(CurrentFileId, "_STATIC_CLASS \\\n");
 
 			WRITE_CLOSE();
 		}
 
-		file << "#undef CURRENT_FILE_ID\n";
-		file << "#define CURRENT_FILE_ID " + GetCurrentFileID(data.FileName) + "\n";
+		file.Append("#undef CURRENT_FILE_ID\n");
+		file.Append("#define CURRENT_FILE_ID ", GetCurrentFileID(data.FileName), "\n");
 	}
 
-	void CodeGenerateHeader::WriteMemberProperties(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateHeader::WriteMemberProperties(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		file << "#define " + currentFileId + "_PROPERTIES \\\n";
+		file.Append("#define ", currentFileId, "_PROPERTIES \\\n");
 		WRITE_PRIVATE();
-		file << "\tstatic Reflect::ReflectMemberProp __REFLECT_MEMBER_PROPS__[" + std::to_string(data.Members.size()) + "];\\\n";
+		file.Append("\tstatic Reflect::ReflectMemberProp __REFLECT_MEMBER_PROPS__[", data.Members.size(), "];\\\n");
+		if (data.Functions.size() > 0)
+		{
+			file.Append("\tstatic Reflect::ReflectFunctionProp __REFLECT_FUNCTION_PROPS__[", data.Functions.size(), "];\\\n");
+		}
+		if (!data.ResolvedBases.empty())
+		{
+			// Flattened tables, see CodeGenerateSource::WriteAllMemberProperties.
+			const size_t allMemberCount = GetAllMemberCount(data);
+			const size_t allFunctionCount = GetAllFunctionCount(data);
+			if (allMemberCount > 0)
+			{
+				file.Append("\tstatic Reflect::ReflectMemberProp __REFLECT_ALL_MEMBER_PROPS__[", allMemberCount, "];\\\n");
+			}
+			if (allFunctionCount > 0)
+			{
+				file.Append("\tstatic Reflect::ReflectFunctionProp __REFLECT_ALL_FUNCTION_PROPS__[", allFunctionCount, "];\\\n");
+			}
+		}
 		WRITE_CLOSE();
 	}
 
-	void CodeGenerateHeader::WriteMemberPropertiesOffsets(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateHeader::WriteMemberPropertiesOffsets(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		file << "#define " + currentFileId + "_PROPERTIES_OFFSET \\\n";
-		WRITE_PRIVATE();
+		// Protected so the flattened tables of derived containers can use the offsets.
+		file.Append("#define ", currentFileId, "_PROPERTIES_OFFSET \\\n");
+		WRITE_PROTECTED();
 		for (const auto& member : data.Members)
 		{
-			file << "\tstatic size_t __REFLECT__" + member.Name + "() { return offsetof(" + data.Name + ", " + member.Name + "); }; \\\n";
+			file.Append("\tstatic size_t __REFLECT__", member.Name, "() { return offsetof(", data.Name, ", ", member.Name, "); }; \\\n");
 		}
 		WRITE_CLOSE();
 	}
 
-	void CodeGenerateHeader::WriteMemberGet(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateHeader::WriteMemberGet(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		file << "#define " + currentFileId + "_PROPERTIES_GET \\\n";
+		file.Append("#define ", currentFileId, "_PROPERTIES_GET \\\n");
 		WRITE_PUBLIC();
-		file << "virtual Reflect::ReflectMember GetMember(const char* memberName) override;\\\n";
-		file << "virtual std::vector<Reflect::ReflectMember> GetMembers(std::vector<std::string> const& flags) override;\\\n";
-		file << "virtual std::vector<Reflect::ReflectMember> GetAllMembers() override;\\\n";
+		file.Append("virtual Reflect::ReflectMember GetMember(const char* memberName) override;\\\n");
+		file.Append("virtual std::vector<Reflect::ReflectMember> GetMembers(std::vector<std::string> const& flags) override;\\\n");
+		file.Append("virtual std::vector<Reflect::ReflectMember> GetAllMembers() override;\\\n");
+		WRITE_CLOSE();
+	}
+
+	void CodeGenerateHeader::WriteFunctions(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		// The bodies are in the generated .cpp (CodeGenerateSource::WriteFunctionBodies) so this header doesn't need FunctionPtrArgs.
+		file.Append("#define ", currentFileId, "_FUNCTION_DECLARE \\\n");
+		WRITE_PROTECTED();
+		for (const auto& func : data.Functions)
+		{
+			file.Append("\tstatic Reflect::EReflectReturnCode __REFLECT_FUNC__", func.Name, "(void* objectPtr, void* returnValuePtr, Reflect::FunctionPtrArgs& functionArgs);\\\n");
+		}
 		WRITE_CLOSE();
 	}
 
-	void CodeGenerateHeader::WriteFunctions(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateHeader::WriteFunctionGet(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		//TODO: Pass in parameters in someway. Prob need to use templates.
+		file.Append("#define ", currentFileId, "_FUNCTION_GET \\\n");
+		WRITE_PUBLIC();
+		file.Append("\tvirtual Reflect::ReflectFunction GetFunction(const char* functionName) override;\\\n");
+		WRITE_CLOSE();
+	}
 
-		auto populateArgs = [](const std::vector<ReflectTypeNameData>& args) -> std::string
+	void CodeGenerateHeader::WriteHash(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		file.Append("#define ", currentFileId, "_HASH \\\n");
+		if (data.ContainsProperty(ReflectContainerFlagHashable))
 		{
-			std::string returnValue;
-			for (const auto& arg : args)
+			WRITE_PUBLIC();
+			file.Append("\tstd::size_t Hash() const;\\\n");
+			file.Append("\tbool Equals(const ", data.Name, "& other) const;\\\n");
+		}
+		WRITE_CLOSE();
+	}
+
+	void CodeGenerateHeader::WriteTypeInfo(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		file.Append("#define ", currentFileId, "_TYPE_INFO \\\n");
+		WRITE_PRIVATE();
+		file.Append("\tstatic Reflect::TypeInfo __REFLECT_TYPE_INFO__;\\\n");
+		WRITE_PUBLIC();
+		file.Append("\tusing __REFLECT_SUPER__ = ", GetReflectSuper(data), ";\\\n");
+		file.Append("\tstatic constexpr Reflect::TypeId StaticTypeId() { return Reflect::GetTypeId(\"", data.Name, "\"); }\\\n");
+		file.Append("\tstatic const Reflect::TypeInfo& StaticTypeInfo() { return __REFLECT_TYPE_INFO__; }\\\n");
+		file.Append("\tvirtual const Reflect::TypeInfo* GetTypeInfo() const override { return &__REFLECT_TYPE_INFO__; }\\\n");
+		WRITE_CLOSE();
+	}
+
+	void CodeGenerateHeader::WriteStaticClass(const ReflectContainerData& data, CodeEmitter& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		auto writeFlags = [&file](const ModelVector<InternedString>& flags, const char* separator)
+		{
+			for (const auto& flag : flags)
 			{
-				if (arg.ReflectValueType == EReflectValueType::Value)
-					returnValue += "*";
-				if (arg.ReflectValueType == EReflectValueType::Reference)
-					returnValue += "*";
-
-				returnValue += arg.Name + "Arg";
-				if (arg != args.back())
-				{
-					returnValue += ", ";
-				}
+				file.Append(&flag == &flags.front() ? separator : ", ", '"', flag, '"');
 			}
-			return returnValue;
-		};
-		auto castToType = [](const Reflect::ReflectTypeNameData& arg) -> std::string
-		{
-			if (arg.ReflectValueType == Reflect::EReflectValueType::Reference || arg.ReflectValueType == Reflect::EReflectValueType::PointerReference)
-				return "static_cast<" + arg.Type + "*>";
-			return "static_cast<" + arg.Type + "*>";
-		};
-		auto returnType = [](const Reflect::ReflectFunctionData& func) -> std::string
-		{
-			std::string result;
-			if (func.ReflectValueType == EReflectValueType::Value)
-				result = "\t\t*(" + func.Type + "*)returnValuePtr = ";
-			else if (func.ReflectValueType == EReflectValueType::Pointer)
-				result = "\t\t*(("+ func.Type +"**)returnValuePtr) = ";
-			else if (func.ReflectValueType == EReflectValueType::Reference)
-				result = "\t\t*((" + func.Type + "**)returnValuePtr) = &";
-			
-			if (func.ReflectValueType != EReflectValueType::Value && func.ReflectModifier == EReflectValueModifier::Const)
-				result += "const_cast<" + func.Type + Util::EReflectValueTypeToString(func.ReflectValueType) +">(";
-
-			return result;
 		};
 
-		file << "#define " + currentFileId + "_FUNCTION_DECLARE \\\n";
-		WRITE_PRIVATE();
-		for (const auto& func : data.Functions)
+		file.Append("#define ", currentFileId, "_STATIC_CLASS \\\n");
+		WRITE_PUBLIC();
+		file.Append("\tstatic constexpr auto __REFLECT_STATIC_CLASS__()\\\n");
+		file.Append("\t{\\\n");
+		file.Append("\t\treturn Reflect::MakeStaticClass<", data.Name, ">(\"", data.Name, "\", Reflect::MakeStaticFlags(");
+		writeFlags(data.ContainerProps, "");
+		file.Append(')');
+		for (const auto& member : data.Members)
 		{
-			file << "\tstatic Reflect::EReflectReturnCode __REFLECT_FUNC__" + func.Name + "(void* objectPtr, void* returnValuePtr, Reflect::FunctionPtrArgs& functionArgs)\\\n";
-			file << "\t{\\\n";
-			int functionArgIndex = 0;
-			for (const auto& arg : func.Parameters)
+			// Pointers to members can't be formed for references and static members are not part of the object.
+			if (member.ReflectModifier == EReflectValueModifier::Static ||
+				member.ReflectValueType == EReflectValueType::Reference ||
+				member.ReflectValueType == EReflectValueType::PointerReference)
 			{
-				file << "\t\t" + GetType(arg, true) + " " + arg.Name + "Arg = " + castToType(arg) + "(functionArgs.GetArg(" + std::to_string(functionArgIndex++) + "));\\\n";
+				continue;
 			}
-			file << "\t\t" + data.Name + "* ptr = static_cast<" + data.Name + "*>(objectPtr);\\\n";
-			// TODO: (01/04/21) Check this cast. If it failed return ReflectFuncReturnCode::CAST_FAILED.
-			file << "\t\tif (ptr == nullptr) { return Reflect::EReflectReturnCode::CAST_FAILED; }\\\n";
-			if (func.Type != "void")
+			file.Append(",\\\n\t\t\tReflect::MakeStaticMember<&", data.Name, "::", member.Name, ">(\"", member.Name, "\", offsetof(", data.Name, ", ", member.Name, ")");
+			writeFlags(member.ContainerProps, ", ");
+			file.Append(')');
+		}
+		file.Append(");\\\n");
+		file.Append("\t}\\\n");
+		WRITE_CLOSE();
+	}
+
+	std::string CodeGenerateHeader::GetReflectSuper(const ReflectContainerData& data)
+	{
+		// Mirror what __super resolves to. If the container inherits directly from REFLECT_BASE() then
+		// IReflect is the end of the chain, otherwise the first public base is the reflected parent.
+		// ReflectStatic casts to it outside the class, so a private/protected base can't be used. Whether the base
+		// is reflected is checked by ReflectStatic (IsReflectedType), it may be in a header which wasn't parsed.
+		for (const auto& base : data.Inheritance)
+		{
+			if (base.Get().find("REFLECT_BASE") != std::string::npos)
 			{
-				file << returnType(func);
+				return "Reflect::IReflect";
 			}
-			else
+		}
+		for (size_t i = 0; i < data.Inheritance.size() && i < data.InheritanceAccess.size(); ++i)
+		{
+			if (data.InheritanceAccess[i] == EReflectAccess::Public)
 			{
-				file << "\t\t";
+				return std::string(data.Inheritance[i].Get());
 			}
-			file << "ptr->" + func.Name + "(" + populateArgs(func.Parameters) + ")";
-
-			if (func.ReflectValueType != EReflectValueType::Value && func.ReflectModifier == EReflectValueModifier::Const)
-				file << ")";
+		}
+		return "Reflect::IReflect";
+	}
 
-			file << ";\\\n";
-			file << "\t\treturn Reflect::EReflectReturnCode::SUCCESS;\\\n";
-			file << "\t}\\\n";
+	size_t CodeGenerateHeader::GetAllMemberCount(const ReflectContainerData& data)
+	{
+		size_t count = data.Members.size();
+		for (const auto& base : data.ResolvedBases)
+		{
+			count += base.Members.size();
 		}
-		WRITE_CLOSE();
+		return count;
 	}
 
-	void CodeGenerateHeader::WriteFunctionGet(const ReflectContainerData& data, std::ofstream& file, const std::string& currentFileId, const ReflectAddtionalOptions& addtionalOptions)
+	size_t CodeGenerateHeader::GetAllFunctionCount(const ReflectContainerData& data)
 	{
-		file << "#define " + currentFileId + "_FUNCTION_GET \\\n";
-		WRITE_PUBLIC();
-		file << "\tvirtual Reflect::ReflectFunction GetFunction(const char* functionName) override;\\\n";
-		WRITE_CLOSE();
+		size_t count = data.Functions.size();
+		for (const auto& base : data.ResolvedBases)
+		{
+			count += base.Functions.size();
+		}
+		return count;
 	}
 
 	std::string CodeGenerateHeader::GetType(const Reflect::ReflectTypeNameData& arg, bool defaultReturnPointer)
@@ -184,6 +246,6 @@ namespace Reflect
 		else if (arg.ReflectValueType == Reflect::EReflectValueType::PointerReference)
 			return arg.Type + "*&";
 		else
-			return defaultReturnPointer ? arg.Type + "*" : arg.Type;
+			return defaultReturnPointer ? arg.Type + "*" : std::string(arg.Type.Get());
 	}
 }
\ No newline at end of file
@@ -4,132 +4,419 @@
 
 namespace Reflect
 {
-	void CodeGenerateSource::GenerateSource(const FileParsedData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateSource::GenerateSource(const FileParsedData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
 	{
 		REFLECT_PROFILE_FUNCTION();
 
-		file << " // This file is auto generated by the Reflect tool please don't modify this file as it will be overwritten.\n";
-
-		//CodeGenerate::IncludeHeader(data.FileName + ReflectFileGeneratePrefix + ".h", file);
-		if (!addtionalOptions.options.at(Reflect_CMD_Option_PCH_Include).empty())
+		// A unity file has the comment and pch include once at the top (CodeGenerate::WriteUnityFiles).
+		if (CodeGenerate::GetUnityFileCount(addtionalOptions) == 0)
 		{
-			CodeGenerate::IncludeHeader(addtionalOptions.options.at(Reflect_CMD_Option_PCH_Include), file);
+			file.Append(" // This file is auto generated by the Reflect tool please don't modify this file as it will be overwritten.\n");
+
+			//CodeGenerate::IncludeHeader(data.FileName + ReflectFileGeneratePrefix + ".h", file);
+			if (!addtionalOptions.options.at(Reflect_CMD_Option_PCH_Include).empty())
+			{
+				CodeGenerate::IncludeHeader(addtionalOptions.options.at(Reflect_CMD_Option_PCH_Include), file);
+			}
 		}
 		CodeGenerate::IncludeHeader("../" + data.FileName + ".h", file);
-		file << "\n";
+		// The generated header only has forward declarations (ReflectFwd.h), the runtime is included here.
+		CodeGenerate::IncludeHeader("Core/TypeRegistry.h", file);
+		file.Append("\n");
 
 		for (const std::string& include : data.CPPIncludes)
 		{
 			CodeGenerate::IncludeHeader(include, file);
 		}
-		file << "\n";
+		auto hashable = std::find_if(data.ReflectData.begin(), data.ReflectData.end(), [](const ReflectContainerData& container)
+			{
+				return container.ContainsProperty(ReflectContainerFlagHashable);
+			});
+		if (hashable != data.ReflectData.end())
+		{
+			CodeGenerate::IncludeHeader("Core/Hash.h", file);
+		}
+		file.Append("\n");
 
 		for (auto& reflectData : data.ReflectData)
 		{
 			WriteMemberProperties(reflectData, file, addtionalOptions);
+			WriteFunctionBodies(reflectData, file, addtionalOptions);
+			WriteFunctionProperties(reflectData, file, addtionalOptions);
+			WriteAllMemberProperties(reflectData, file, addtionalOptions);
 			WriteFunctionGet(reflectData, file, addtionalOptions);
 			WriteMemberGet(reflectData, file, addtionalOptions);
+			WriteHash(reflectData, file, addtionalOptions);
+			WriteTypeInfo(reflectData, file, addtionalOptions);
+		}
+	}
+
+	void CodeGenerateSource::WriteMemberProperties(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		if (data.Members.size() > 0)
+		{
+			file.Append("Reflect::ReflectMemberProp ", data.Name, "::__REFLECT_MEMBER_PROPS__[", data.Members.size(), "] = {\n");
+			for (const auto& member : data.Members)
+			{
+				WriteMemberProp(member, "", file);
+			}
+			file.Append("};\n\n");
 		}
 	}
 
-	void CodeGenerateSource::WriteMemberProperties(const ReflectContainerData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateSource::WriteAllMemberProperties(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		auto getMemberProps = [](const std::vector<std::string>& flags) -> std::string
+		if (data.ResolvedBases.empty())
 		{
-			if (flags.size() == 0)
+			return;
+		}
+
+		// The members/functions of the bases are moved by the offset of the base in this container, so the
+		// flattened tables work from 'this' like the container's own tables. Bases come first, as with __super.
+		const size_t allMemberCount = CodeGenerateHeader::GetAllMemberCount(data);
+		if (allMemberCount > 0)
+		{
+			file.Append("Reflect::ReflectMemberProp ", data.Name, "::__REFLECT_ALL_MEMBER_PROPS__[", allMemberCount, "] = {\n");
+			for (const auto& base : data.ResolvedBases)
+			{
+				const std::string baseOffset = "Reflect::BaseOffset<" + data.Name + ", " + base.Name + ">() + " + base.Name + "::";
+				for (const auto& member : base.Members)
+				{
+					WriteMemberProp(member, baseOffset, file);
+				}
+			}
+			for (const auto& member : data.Members)
+			{
+				WriteMemberProp(member, "", file);
+			}
+			file.Append("};\n\n");
+		}
+
+		const size_t allFunctionCount = CodeGenerateHeader::GetAllFunctionCount(data);
+		if (allFunctionCount > 0)
+		{
+			file.Append("Reflect::ReflectFunctionProp ", data.Name, "::__REFLECT_ALL_FUNCTION_PROPS__[", allFunctionCount, "] = {\n");
+			for (const auto& base : data.ResolvedBases)
+			{
+				for (const auto& func : base.Functions)
+				{
+					file.Append("\tReflect::ReflectFunctionProp(\"", func.Name, "\", ", base.Name, "::__REFLECT_FUNC__", func.Name, ", Reflect::BaseOffset<", data.Name, ", ", base.Name, ">()),\n");
+				}
+			}
+			for (const auto& func : data.Functions)
 			{
-				return "{ }";
+				file.Append("\tReflect::ReflectFunctionProp(\"", func.Name, "\", ", data.Name, "::__REFLECT_FUNC__", func.Name, "),\n");
 			}
+			file.Append("};\n\n");
+		}
+	}
 
-			std::string value;
-			value += "{";
+	void CodeGenerateSource::WriteMemberProp(const ReflectMemberData& member, const std::string& offsetPrefix, CodeEmitter& file)
+	{
+		file.Append("\tReflect::ReflectMemberProp(\"", member.Name, "\", new Reflect::ReflectTypeCPP<", CodeGenerateHeader::GetType(member, false), ">(), ", offsetPrefix, "__REFLECT__", member.Name, "(), ");
+		const ModelVector<InternedString>& flags = member.ContainerProps;
+		if (flags.size() == 0)
+		{
+			file.Append("{ }");
+		}
+		else
+		{
+			file.Append('{');
 			for (auto const& flag : flags)
 			{
 				if (flag != flags.back())
 				{
-					value += "\"" + flag + "\"" + ", ";
+					file.Append('"', flag, "\", ");
 				}
 			}
-			value += "\"" + flags.back() + "\"" + "}";
-			return value;
+			file.Append('"', flags.back(), "\"}");
+		}
+		file.Append("),\n");
+	}
+
+	void CodeGenerateSource::WriteFunctionBodies(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		//TODO: Pass in parameters in someway. Prob need to use templates.
+
+		auto populateArgs = [&file](const ModelVector<ReflectTypeNameData>& args)
+		{
+			for (const auto& arg : args)
+			{
+				if (arg.ReflectValueType == EReflectValueType::Value)
+					file.Append('*');
+				if (arg.ReflectValueType == EReflectValueType::Reference)
+					file.Append('*');
+
+				file.Append(arg.Name, "Arg");
+				if (arg != args.back())
+				{
+					file.Append(", ");
+				}
+			}
+		};
+		auto returnType = [&file](const Reflect::ReflectFunctionData& func)
+		{
+			if (func.ReflectValueType == EReflectValueType::Value)
+				file.Append("\t*(", func.Type, "*)returnValuePtr = ");
+			else if (func.ReflectValueType == EReflectValueType::Pointer)
+				file.Append("\t*((", func.Type, "**)returnValuePtr) = ");
+			else if (func.ReflectValueType == EReflectValueType::Reference)
+				file.Append("\t*((", func.Type, "**)returnValuePtr) = &");
+			
+			if (func.ReflectValueType != EReflectValueType::Value && func.ReflectModifier == EReflectValueModifier::Const)
+				file.Append("const_cast<", func.Type, Util::EReflectValueTypeToString(func.ReflectValueType), ">(");
 		};
 
-		if (data.Members.size() > 0)
+		for (const auto& func : data.Functions)
 		{
-			file << "Reflect::ReflectMemberProp " + data.Name + "::__REFLECT_MEMBER_PROPS__[" + std::to_string(data.Members.size()) + "] = {\n";
-			for (const auto& member : data.Members)
+			file.Append("Reflect::EReflectReturnCode ", data.Name, "::__REFLECT_FUNC__", func.Name, "(void* objectPtr, void* returnValuePtr, Reflect::FunctionPtrArgs& functionArgs)\n");
+			file.Append("{\n");
+			int functionArgIndex = 0;
+			for (const auto& arg : func.Parameters)
 			{
-				file << "\tReflect::ReflectMemberProp(\"" + member.Name + 
-					"\", new Reflect::ReflectTypeCPP<" + CodeGenerateHeader::GetType(member, false) + ">(), " +
-					 "__REFLECT__" + member.Name + "(), " + 
-					getMemberProps(member.ContainerProps) + "),\n";
+				file.Append('\t', CodeGenerateHeader::GetType(arg, true), " ", arg.Name, "Arg = static_cast<", arg.Type, "*>(functionArgs.GetArg(", functionArgIndex++, "));\n");
 			}
-			file << "};\n\n";
+			file.Append('\t', data.Name, "* ptr = static_cast<", data.Name, "*>(objectPtr);\n");
+			// TODO: (01/04/21) Check this cast. If it failed return ReflectFuncReturnCode::CAST_FAILED.
+			file.Append("\tif (ptr == nullptr) { return Reflect::EReflectReturnCode::CAST_FAILED; }\n");
+			if (func.Type != "void")
+			{
+				returnType(func);
+			}
+			else
+			{
+				file.Append('\t');
+			}
+			file.Append("ptr->", func.Name, "(");
+			populateArgs(func.Parameters);
+			file.Append(')');
+
+			if (func.ReflectValueType != EReflectValueType::Value && func.ReflectModifier == EReflectValueModifier::Const)
+				file.Append(')');
+
+			file.Append(";\n");
+			file.Append("\treturn Reflect::EReflectReturnCode::SUCCESS;\n");
+			file.Append("}\n\n");
 		}
 	}
 
-	void CodeGenerateSource::WriteMemberGet(const ReflectContainerData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateSource::WriteFunctionProperties(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		file << "Reflect::ReflectMember " + data.Name + "::GetMember(const char* memberName)\n{\n";
-		if (data.Members.size() > 0)
+		if (data.Functions.size() > 0)
 		{
-			file << "\tfor(const auto& member : __REFLECT_MEMBER_PROPS__)\n\t{\n";
-			file << "\t\tif(memberName == member.Name)\n";
-			file << "\t\t{\n";
-			file << "\t\t\t//CheckFlags\n";
-			file << "\t\t\treturn " + MemberFormat() + "; \n";
-			file << "\t\t}\n";
-			file << "\t}\n";
+			file.Append("Reflect::ReflectFunctionProp ", data.Name, "::__REFLECT_FUNCTION_PROPS__[", data.Functions.size(), "] = {\n");
+			for (const auto& func : data.Functions)
+			{
+				file.Append("\tReflect::ReflectFunctionProp(\"", func.Name, "\", ", data.Name, "::__REFLECT_FUNC__", func.Name, "),\n");
+			}
+			file.Append("};\n\n");
 		}
-		file << "\treturn __super::GetMember(memberName);\n";
-		file << "}\n\n";
+	}
 
-		file << "std::vector<Reflect::ReflectMember> " + data.Name + "::GetMembers(std::vector<std::string> const& flags)\n{\n";
-		file << "\tstd::vector<Reflect::ReflectMember> members = __super::GetMembers(flags);\n";
+	void CodeGenerateSource::WriteMemberGet(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		file.Append("Reflect::ReflectMember ", data.Name, "::GetMember(const char* memberName)\n{\n");
 		if (data.Members.size() > 0)
 		{
-			file << "\tfor(auto& member : __REFLECT_MEMBER_PROPS__)\n\t{\n";
-			file << "\t\tif(member.ContainsProperty(flags))\n";
-			file << "\t\t{\n";
-			file << "\t\t\tmembers.push_back(" + MemberFormat() + "); \n";
-			file << "\t\t}\n";
-			file << "\t}\n";
+			file.Append("\tfor(const auto& member : __REFLECT_MEMBER_PROPS__)\n\t{\n");
+			file.Append("\t\tif(memberName == member.Name)\n");
+			file.Append("\t\t{\n");
+			file.Append("\t\t\t//CheckFlags\n");
+			file.Append("\t\t\treturn ", MemberFormat(), "; \n");
+			file.Append("\t\t}\n");
+			file.Append("\t}\n");
 		}
-		file << "\treturn members;\n";
-		file << "}\n\n";
+		file.Append("\treturn __super::GetMember(memberName);\n");
+		file.Append("}\n\n");
 
-		file << "std::vector<Reflect::ReflectMember> " + data.Name + "::GetAllMembers()\n{\n";
-		file << "\tstd::vector<Reflect::ReflectMember> members = __super::GetAllMembers();\n";
-		if (data.Members.size() > 0)
+		// With the bases resolved the flattened table has the whole hierarchy, one scan and no virtual calls up the chain.
+		const bool flattened = !data.ResolvedBases.empty();
+		const size_t allMemberCount = flattened ? CodeGenerateHeader::GetAllMemberCount(data) : data.Members.size();
+		const char* memberProps = flattened ? "__REFLECT_ALL_MEMBER_PROPS__" : "__REFLECT_MEMBER_PROPS__";
+
+		file.Append("std::vector<Reflect::ReflectMember> ", data.Name, "::GetMembers(std::vector<std::string> const& flags)\n{\n");
+		if (flattened)
+		{
+			file.Append("\tstd::vector<Reflect::ReflectMember> members;\n");
+		}
+		else
 		{
-			file << "\tfor(auto& member : __REFLECT_MEMBER_PROPS__)\n\t{\n";
-			file << "\t\tmembers.push_back(" + MemberFormat() + "); \n";
-			file << "\t}\n";
+			file.Append("\tstd::vector<Reflect::ReflectMember> members = __super::GetMembers(flags);\n");
 		}
-		file << "\treturn members;\n";
-		file << "}\n\n";
+		if (allMemberCount > 0)
+		{
+			file.Append("\tfor(auto& member : ", memberProps, ")\n\t{\n");
+			file.Append("\t\tif(member.ContainsProperty(flags))\n");
+			file.Append("\t\t{\n");
+			file.Append("\t\t\tmembers.push_back(", MemberFormat(), "); \n");
+			file.Append("\t\t}\n");
+			file.Append("\t}\n");
+		}
+		file.Append("\treturn members;\n");
+		file.Append("}\n\n");
+
+		file.Append("std::vector<Reflect::ReflectMember> ", data.Name, "::GetAllMembers()\n{\n");
+		if (flattened)
+		{
+			file.Append("\tstd::vector<Reflect::ReflectMember> members;\n");
+			file.Append("\tmembers.reserve(", allMemberCount, ");\n");
+		}
+		else
+		{
+			file.Append("\tstd::vector<Reflect::ReflectMember> members = __super::GetAllMembers();\n");
+		}
+		if (allMemberCount > 0)
+		{
+			file.Append("\tfor(auto& member : ", memberProps, ")\n\t{\n");
+			file.Append("\t\tmembers.push_back(", MemberFormat(), "); \n");
+			file.Append("\t}\n");
+		}
+		file.Append("\treturn members;\n");
+		file.Append("}\n\n");
 	}
 
-	void CodeGenerateSource::WriteFunctionGet(const ReflectContainerData& data, std::ofstream& file, const ReflectAddtionalOptions& addtionalOptions)
+	void CodeGenerateSource::WriteFunctionGet(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
 	{
-		file << "Reflect::ReflectFunction " + data.Name + "::GetFunction(const char* functionName)\n{\n";
+		file.Append("Reflect::ReflectFunction ", data.Name, "::GetFunction(const char* functionName)\n{\n");
 		for (const auto& func : data.Functions)
 		{
-			file << "\tif(functionName == \"" + func.Name + "\")\n";
-			file << "\t{\n";
-			file << "\t\treturn Reflect::ReflectFunction(this, " + data.Name + "::__REFLECT_FUNC__" + func.Name + ");\n";
-			file << "\t}\n";
+			file.Append("\tif(functionName == \"", func.Name, "\")\n");
+			file.Append("\t{\n");
+			file.Append("\t\treturn Reflect::ReflectFunction(this, ", data.Name, "::__REFLECT_FUNC__", func.Name, ");\n");
+			file.Append("\t}\n");
+		}
+		file.Append("\treturn __super::GetFunction(functionName);\n");
+		file.Append("}\n\n");
+	}
+
+	void CodeGenerateSource::WriteHash(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		if (!data.ContainsProperty(ReflectContainerFlagHashable))
+		{
+			return;
+		}
+
+		// Static members are not part of the object's value.
+		std::vector<const ReflectMemberData*> members;
+		bool trivialSpanCandidate = true;
+		for (const auto& member : data.Members)
+		{
+			if (member.ReflectModifier == EReflectValueModifier::Static)
+			{
+				continue;
+			}
+			if (member.ReflectValueType == EReflectValueType::Reference || member.ReflectValueType == EReflectValueType::PointerReference)
+			{
+				trivialSpanCandidate = false;
+			}
+			members.push_back(&member);
+		}
+		trivialSpanCandidate &= members.size() > 1;
+
+		// If every member has a unique object representation and they are packed together
+		// then the whole span can be hashed/compared in one go.
+		std::string spanBegin;
+		std::string spanEnd;
+		std::string spanCheck;
+		if (trivialSpanCandidate)
+		{
+			spanBegin = "offsetof(" + data.Name + ", " + members.front()->Name + ")";
+			spanEnd = "(offsetof(" + data.Name + ", " + members.back()->Name + ") + sizeof(" + data.Name + "::" + members.back()->Name + "))";
+			spanCheck = "Reflect::Hash::IsTrivialSpan<";
+			for (const auto* member : members)
+			{
+				spanCheck += "decltype(" + data.Name + "::" + member->Name + ")";
+				if (member != members.back())
+				{
+					spanCheck += ", ";
+				}
+			}
+			spanCheck += ">(" + spanBegin + ", " + spanEnd + ")";
+		}
+
+		file.Append("std::size_t ", data.Name, "::Hash() const\n{\n");
+		file.Append("\tuint64_t hash = Reflect::Hash::DefaultSeed;\n");
+		std::string indent = "\t";
+		if (trivialSpanCandidate)
+		{
+			file.Append("\tif constexpr (", spanCheck, ")\n");
+			file.Append("\t{\n");
+			file.Append("\t\thash = Reflect::Hash::HashBytes(&", members.front()->Name, ", ", spanEnd, " - ", spanBegin, ", hash);\n");
+			file.Append("\t}\n");
+			file.Append("\telse\n");
+			file.Append("\t{\n");
+			indent = "\t\t";
+		}
+		for (const auto* member : members)
+		{
+			file.Append(indent, "hash = Reflect::Hash::Combine(hash, Reflect::Hash::HashValue(", member->Name, "));\n");
+		}
+		if (trivialSpanCandidate)
+		{
+			file.Append("\t}\n");
+		}
+		file.Append("\treturn static_cast<std::size_t>(hash);\n");
+		file.Append("}\n\n");
+
+		file.Append("bool ", data.Name, "::Equals(const ", data.Name, "& other) const\n{\n");
+		if (trivialSpanCandidate)
+		{
+			file.Append("\tif constexpr (", spanCheck, ")\n");
+			file.Append("\t{\n");
+			file.Append("\t\treturn memcmp(&", members.front()->Name, ", &other.", members.front()->Name, ", ", spanEnd, " - ", spanBegin, ") == 0;\n");
+			file.Append("\t}\n");
+			file.Append("\telse\n");
+			file.Append("\t{\n");
+		}
+		for (const auto* member : members)
+		{
+			file.Append(indent, "if (!Reflect::Hash::Equal(", member->Name, ", other.", member->Name, ")) { return false; }\n");
+		}
+		file.Append(indent, "return true;\n");
+		if (trivialSpanCandidate)
+		{
+			file.Append("\t}\n");
+		}
+		file.Append("}\n\n");
+	}
+
+	void CodeGenerateSource::WriteTypeInfo(const ReflectContainerData& data, CodeEmitter& file, const ReflectAddtionalOptions& addtionalOptions)
+	{
+		std::string inheritance;
+		for (const auto& base : data.Inheritance)
+		{
+			inheritance += "\"" + base + "\"";
+			if (base != data.Inheritance.back())
+			{
+				inheritance += ", ";
+			}
+		}
+
+		const std::string members = data.Members.size() > 0 ? data.Name + "::__REFLECT_MEMBER_PROPS__" : "nullptr";
+		const std::string functions = data.Functions.size() > 0 ? data.Name + "::__REFLECT_FUNCTION_PROPS__" : "nullptr";
+
+		file.Append("Reflect::TypeInfo ", data.Name, "::__REFLECT_TYPE_INFO__(\n");
+		file.Append("\t\"", data.Name, "\", ", data.Name, "::StaticTypeId(), sizeof(", data.Name, "), alignof(", data.Name, "),\n");
+		file.Append("\t{ ", inheritance, " },\n");
+		file.Append("\t", members, ", ", data.Members.size(), ",\n");
+		file.Append("\t", functions, ", ", data.Functions.size(), ",\n");
+		file.Append("\tReflect::TypeInfo::GetConstructFunc<", data.Name, ">(), Reflect::TypeInfo::GetDestructFunc<", data.Name, ">()");
+		if (!data.ResolvedBases.empty())
+		{
+			const size_t allMemberCount = CodeGenerateHeader::GetAllMemberCount(data);
+			const size_t allFunctionCount = CodeGenerateHeader::GetAllFunctionCount(data);
+			file.Append(",\n\t", allMemberCount > 0 ? data.Name + "::__REFLECT_ALL_MEMBER_PROPS__" : "nullptr", ", ", allMemberCount, ",\n");
+			file.Append("\t", allFunctionCount > 0 ? data.Name + "::__REFLECT_ALL_FUNCTION_PROPS__" : "nullptr", ", ", allFunctionCount);
 		}
-		file << "\treturn __super::GetFunction(functionName);\n";
-		file << "}\n\n";
+		file.Append(");\n\n");
 	}
 
-	std::string CodeGenerateSource::MemberFormat()
+	const char* CodeGenerateSource::MemberFormat()
 	{
 		return "Reflect::ReflectMember(member.Name, member.Type, ((char*)this) + member.Offset)";
 	}
 
-	//void CodeGenerateSource::WriteFunctionBindings(const ReflectContainerData& data, std::ofstream& file)
+	//void CodeGenerateSource::WriteFunctionBindings(const ReflectContainerData& data, std::ostream& file)
 	//{
 	//	file << "\t" + data.Name << "* ptr = dynamic_cast<" + data.Name + "*>(this);\n";
 	//	file << "\tassert(ptr != nullptr && \"[" + data.Name + ContainerPrefix + "::" + "SetupReflectBindings()] 'ptr' should not be null.\");\n\n";
@@ -0,0 +1,83 @@
+#include "Core/RunStats.h"
+#include "Instrumentor.h"
+#include <new>
+#include <stdlib.h>
+
+namespace Reflect
+{
+	namespace
+	{
+		// One counter per thread for the whole process, the library and the application share it through Get().
+		thread_local uint64_t AllocationCount = 0;
+	}
+
+	uint64_t AllocationCounter::Get()
+	{
+		return AllocationCount;
+	}
+
+	void AllocationCounter::RecordAllocation()
+	{
+		++AllocationCount;
+	}
+
+	bool AllocationCounter::IsEnabled()
+	{
+#if defined(REFLECT_TRACK_ALLOCATIONS)
+		return true;
+#else
+		return false;
+#endif
+	}
+}
+
+#if defined(REFLECT_TRACK_ALLOCATIONS)
+// Replaces the global operator new/delete of the module this is linked into (premake --track-allocations).
+// Every allocation is counted for the run report, and with profiling compiled in also tracked by the profiler
+// so the trace has a "Memory" counter track. The size is stored in front of each allocation so it is known
+// again on delete. The sized and array forms are replaced too so every allocation goes through the same new/delete pair.
+constexpr size_t AllocationHeaderSize = alignof(std::max_align_t);
+
+void* operator new(size_t size)
+{
+	void* memory = malloc(size + AllocationHeaderSize);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	*static_cast<size_t*>(memory) = size;
+	Reflect::AllocationCounter::RecordAllocation();
+	REFLECT_PROFILE_ALLOCATION(size);
+	return static_cast<char*>(memory) + AllocationHeaderSize;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory != nullptr)
+	{
+		void* block = static_cast<char*>(memory) - AllocationHeaderSize;
+		REFLECT_PROFILE_DEALLOCATION(*static_cast<size_t*>(block));
+		free(block);
+	}
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+#endif
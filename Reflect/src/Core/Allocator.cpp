@@ -0,0 +1,107 @@
+#include "Core/Allocator.h"
+#include <algorithm>
+
+namespace Reflect
+{
+	constexpr std::size_t ArenaBlockAlignment = alignof(std::max_align_t);
+
+	HeapAllocator& HeapAllocator::Get()
+	{
+		static HeapAllocator instance;
+		return instance;
+	}
+
+	PoolAllocator::PoolAllocator(std::size_t blockSize, std::size_t alignment, std::size_t blocksPerChunk)
+		: m_alignment(std::max(alignment, alignof(FreeBlock)))
+		, m_blocksPerChunk(std::max<std::size_t>(blocksPerChunk, 1))
+		, m_freeList(nullptr)
+	{
+		// Every block must be able to hold the free list link and keep the next block aligned.
+		blockSize = std::max(blockSize, sizeof(FreeBlock));
+		m_blockSize = (blockSize + m_alignment - 1) & ~(m_alignment - 1);
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		for (void* chunk : m_chunks)
+		{
+			::operator delete(chunk, std::align_val_t(m_alignment));
+		}
+	}
+
+	void PoolAllocator::AllocateChunk()
+	{
+		char* chunk = static_cast<char*>(::operator new(m_blockSize * m_blocksPerChunk, std::align_val_t(m_alignment)));
+		m_chunks.push_back(chunk);
+
+		// Link the blocks in address order so allocations from a fresh chunk are sequential.
+		for (std::size_t i = m_blocksPerChunk; i > 0; --i)
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_blockSize);
+			block->Next = m_freeList;
+			m_freeList = block;
+		}
+	}
+
+	ArenaAllocator::ArenaAllocator(std::size_t blockSize)
+		: m_blockSize(blockSize)
+		, m_bytesReserved(0)
+		, m_current(nullptr)
+		, m_end(nullptr)
+		, m_cleanups(nullptr)
+	{ }
+
+	ArenaAllocator::~ArenaAllocator()
+	{
+		Reset();
+		for (const Block& block : m_blocks)
+		{
+			::operator delete(block.Memory, std::align_val_t(ArenaBlockAlignment));
+		}
+	}
+
+	bool ArenaAllocator::AddCleanup(CleanupFunc func, void* data)
+	{
+		Cleanup* cleanup = static_cast<Cleanup*>(Allocate(sizeof(Cleanup), alignof(Cleanup)));
+		cleanup->Func = func;
+		cleanup->Data = data;
+		cleanup->Next = m_cleanups;
+		m_cleanups = cleanup;
+		return true;
+	}
+
+	void ArenaAllocator::Reset()
+	{
+		while (m_cleanups)
+		{
+			Cleanup* cleanup = m_cleanups;
+			m_cleanups = cleanup->Next;
+			cleanup->Func(cleanup->Data);
+		}
+
+		// Keep the first block around so the next load doesn't have to go back to the heap.
+		for (std::size_t i = 1; i < m_blocks.size(); ++i)
+		{
+			::operator delete(m_blocks[i].Memory, std::align_val_t(ArenaBlockAlignment));
+		}
+		if (!m_blocks.empty())
+		{
+			m_blocks.resize(1);
+			m_current = m_blocks[0].Memory;
+			m_end = m_blocks[0].Memory + m_blocks[0].Size;
+			m_bytesReserved = m_blocks[0].Size;
+		}
+	}
+
+	void* ArenaAllocator::AllocateSlow(std::size_t size, std::size_t alignment)
+	{
+		std::size_t blockSize = std::max(m_blockSize, size + alignment);
+		char* memory = static_cast<char*>(::operator new(blockSize, std::align_val_t(ArenaBlockAlignment)));
+		m_blocks.push_back({ memory, blockSize });
+		m_bytesReserved += blockSize;
+
+		m_current = memory;
+		m_end = memory + blockSize;
+		return Allocate(size, alignment);
+	}
+}
@@ -12,6 +12,23 @@ namespace Reflect
 		return EReflectFlags::Invalid;
 	}
 
+	const char* ReflectAccessToString(EReflectAccess access)
+	{
+		switch (access)
+		{
+			case EReflectAccess::Public: return "public";
+			case EReflectAccess::Protected: return "protected";
+			default: return "private";
+		}
+	}
+
+	EReflectAccess StringToReflectAccess(const std::string& str)
+	{
+		if (str == "public") return EReflectAccess::Public;
+		else if (str == "protected") return EReflectAccess::Protected;
+		return EReflectAccess::Private;
+	}
+
 	std::string ReflectReturnCodeToString(const EReflectReturnCode& code)
 	{
 		switch (code)
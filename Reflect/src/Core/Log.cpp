@@ -0,0 +1,32 @@
+#include "Core/Log.h"
+
+namespace Reflect
+{
+	namespace Log
+	{
+		AsyncLogger& AsyncLogger::Get()
+		{
+			// Never destroyed, so no static destructor joins the writer thread. Shutdown() does.
+			static AsyncLogger* instance = new AsyncLogger();
+			return *instance;
+		}
+
+		void AsyncLogger::Shutdown()
+		{
+			// Synchronous from here, and stop the writer from being started by a later Push.
+			m_async.store(false, std::memory_order_relaxed);
+			std::call_once(m_startWriter, []() { });
+
+			{
+				std::lock_guard lock(m_mutex);
+				m_stop = true;
+			}
+			m_condition.notify_one();
+			if (m_writerThread.joinable())
+			{
+				m_writerThread.join();
+			}
+			Flush();
+		}
+	}
+}
@@ -0,0 +1,306 @@
+#include "Core/RunStats.h"
+#include <algorithm>
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Reflect
+{
+	constexpr size_t PhaseCount = static_cast<size_t>(EReflectPhase::Count);
+
+	const char* ReflectPhaseToString(EReflectPhase phase)
+	{
+		switch (phase)
+		{
+		case EReflectPhase::DirectoryWalk: return "Directory walk";
+		case EReflectPhase::Load: return "Load";
+		case EReflectPhase::Parse: return "Parse";
+		case EReflectPhase::CodeGenerate: return "Code generate";
+		case EReflectPhase::Write: return "Write";
+		default: return "Unknown";
+		}
+	}
+
+	RunStats& RunStats::Get()
+	{
+		static RunStats instance;
+		return instance;
+	}
+
+	void RunStats::Reset()
+	{
+		std::lock_guard lock(m_mutex);
+		std::fill(std::begin(m_phaseTime), std::end(m_phaseTime), 0);
+		m_files.clear();
+		m_fileIndex.clear();
+		m_containers.clear();
+	}
+
+	void RunStats::AddPhaseTime(EReflectPhase phase, int64_t nanoseconds)
+	{
+		std::lock_guard lock(m_mutex);
+		m_phaseTime[static_cast<size_t>(phase)] += nanoseconds;
+	}
+
+	void RunStats::AddFileTime(const std::string& file, EReflectPhase phase, int64_t nanoseconds, size_t bytes)
+	{
+		std::lock_guard lock(m_mutex);
+		m_phaseTime[static_cast<size_t>(phase)] += nanoseconds;
+		FileStats& stats = FindOrAddFile(file);
+		stats.PhaseTime[static_cast<size_t>(phase)] += nanoseconds;
+		stats.Bytes += bytes;
+	}
+
+	void RunStats::AddFileParseAllocations(const std::string& file, uint64_t allocations)
+	{
+		std::lock_guard lock(m_mutex);
+		FindOrAddFile(file).ParseAllocations += allocations;
+	}
+
+	void RunStats::AddContainer(ContainerStats container)
+	{
+		std::lock_guard lock(m_mutex);
+		m_containers.push_back(std::move(container));
+	}
+
+	int64_t RunStats::GetPhaseTime(EReflectPhase phase) const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_phaseTime[static_cast<size_t>(phase)];
+	}
+
+	size_t RunStats::GetFileCount() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_files.size();
+	}
+
+	size_t RunStats::GetTotalBytes() const
+	{
+		std::lock_guard lock(m_mutex);
+		size_t bytes = 0;
+		for (const FileStats& file : m_files)
+		{
+			bytes += file.Bytes;
+		}
+		return bytes;
+	}
+
+	std::vector<FileStats> RunStats::GetSlowestFiles(size_t count) const
+	{
+		std::vector<FileStats> files;
+		{
+			std::lock_guard lock(m_mutex);
+			files = m_files;
+		}
+		count = std::min(count, files.size());
+		std::partial_sort(files.begin(), files.begin() + count, files.end(), [](const FileStats& a, const FileStats& b)
+			{
+				return a.GetTotalTime() > b.GetTotalTime();
+			});
+		files.resize(count);
+		return files;
+	}
+
+	std::vector<ContainerStats> RunStats::GetSlowestContainers(size_t count) const
+	{
+		std::vector<ContainerStats> containers;
+		{
+			std::lock_guard lock(m_mutex);
+			containers = m_containers;
+		}
+		count = std::min(count, containers.size());
+		std::partial_sort(containers.begin(), containers.begin() + count, containers.end(), [](const ContainerStats& a, const ContainerStats& b)
+			{
+				return a.ParseTime > b.ParseTime;
+			});
+		containers.resize(count);
+		return containers;
+	}
+
+	size_t RunStats::GetPeakRSS()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters = {};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		{
+			return counters.PeakWorkingSetSize;
+		}
+		return 0;
+#else
+		rusage usage = {};
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+		{
+			return 0;
+		}
+#ifdef __APPLE__
+		return static_cast<size_t>(usage.ru_maxrss);
+#else
+		// Linux reports kilobytes.
+		return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+	}
+
+	FileStats& RunStats::FindOrAddFile(const std::string& file)
+	{
+		auto itr = m_fileIndex.find(file);
+		if (itr != m_fileIndex.end())
+		{
+			return m_files[itr->second];
+		}
+		m_fileIndex[file] = m_files.size();
+		FileStats& stats = m_files.emplace_back();
+		stats.File = file;
+		return stats;
+	}
+
+	namespace
+	{
+		double ToSeconds(int64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1e9; }
+		double ToMilliseconds(int64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1e6; }
+		double ToMegabytes(size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+		double PerSecond(double value, int64_t nanoseconds) { return nanoseconds > 0 ? value / ToSeconds(nanoseconds) : 0.0; }
+
+		void AppendJsonString(std::string& json, const std::string& str)
+		{
+			json += '"';
+			for (char c : str)
+			{
+				if (c == '"' || c == '\\')
+				{
+					json += '\\';
+				}
+				json += c;
+			}
+			json += '"';
+		}
+	}
+
+	std::string RunStats::ToString(int64_t wallTime, size_t slowestCount) const
+	{
+		size_t fileCount = GetFileCount();
+		size_t totalBytes = GetTotalBytes();
+		char buffer[512];
+		std::string report = "Reflect run report\n";
+
+		snprintf(buffer, sizeof(buffer), "  Files: %zu (%.2f MB) in %.2f ms, %.1f files/sec, %.2f MB/sec\n",
+			fileCount, ToMegabytes(totalBytes), ToMilliseconds(wallTime), PerSecond(static_cast<double>(fileCount), wallTime), PerSecond(ToMegabytes(totalBytes), wallTime));
+		report += buffer;
+
+		report += "  Phases:\n";
+		for (size_t i = 0; i < PhaseCount; ++i)
+		{
+			int64_t phaseTime = GetPhaseTime(static_cast<EReflectPhase>(i));
+			snprintf(buffer, sizeof(buffer), "    %-16s %10.2f ms %6.1f%% %10.1f files/sec %8.2f MB/sec\n",
+				ReflectPhaseToString(static_cast<EReflectPhase>(i)), ToMilliseconds(phaseTime), wallTime > 0 ? 100.0 * phaseTime / wallTime : 0.0,
+				PerSecond(static_cast<double>(fileCount), phaseTime), PerSecond(ToMegabytes(totalBytes), phaseTime));
+			report += buffer;
+		}
+
+		std::vector<FileStats> slowest = GetSlowestFiles(slowestCount);
+		if (!slowest.empty())
+		{
+			report += "  Slowest files:\n";
+			for (const FileStats& file : slowest)
+			{
+				snprintf(buffer, sizeof(buffer), "    %10.2f ms %10zu bytes ", ToMilliseconds(file.GetTotalTime()), file.Bytes);
+				report += buffer;
+				if (AllocationCounter::IsEnabled())
+				{
+					snprintf(buffer, sizeof(buffer), "%8llu parse allocations ", static_cast<unsigned long long>(file.ParseAllocations));
+					report += buffer;
+				}
+				report += ' ';
+				report += file.File + "\n";
+			}
+		}
+
+		std::vector<ContainerStats> slowestContainers = GetSlowestContainers(slowestCount);
+		if (!slowestContainers.empty())
+		{
+			report += "  Slowest containers to parse:\n";
+			for (const ContainerStats& container : slowestContainers)
+			{
+				snprintf(buffer, sizeof(buffer), "    %10.2f ms %10zu bytes ", ToMilliseconds(container.ParseTime), container.BytesScanned);
+				report += buffer;
+				if (AllocationCounter::IsEnabled())
+				{
+					snprintf(buffer, sizeof(buffer), "%8llu allocations ", static_cast<unsigned long long>(container.Allocations));
+					report += buffer;
+				}
+				report += ' ';
+				report += container.Container + " (" + container.File + ")\n";
+			}
+		}
+
+		snprintf(buffer, sizeof(buffer), "  Peak RSS: %.2f MB\n", ToMegabytes(GetPeakRSS()));
+		report += buffer;
+		return report;
+	}
+
+	std::string RunStats::ToJson(int64_t wallTime, size_t slowestCount) const
+	{
+		size_t fileCount = GetFileCount();
+		size_t totalBytes = GetTotalBytes();
+		char buffer[256];
+		std::string json = "{";
+
+		snprintf(buffer, sizeof(buffer), "\"wallTimeMs\":%.3f,\"fileCount\":%zu,\"totalBytes\":%zu,\"filesPerSec\":%.3f,\"mbPerSec\":%.3f,\"peakRssBytes\":%zu,",
+			ToMilliseconds(wallTime), fileCount, totalBytes, PerSecond(static_cast<double>(fileCount), wallTime), PerSecond(ToMegabytes(totalBytes), wallTime), GetPeakRSS());
+		json += buffer;
+
+		json += "\"phases\":[";
+		for (size_t i = 0; i < PhaseCount; ++i)
+		{
+			int64_t phaseTime = GetPhaseTime(static_cast<EReflectPhase>(i));
+			json += i == 0 ? "{\"name\":" : ",{\"name\":";
+			AppendJsonString(json, ReflectPhaseToString(static_cast<EReflectPhase>(i)));
+			snprintf(buffer, sizeof(buffer), ",\"timeMs\":%.3f,\"filesPerSec\":%.3f,\"mbPerSec\":%.3f}",
+				ToMilliseconds(phaseTime), PerSecond(static_cast<double>(fileCount), phaseTime), PerSecond(ToMegabytes(totalBytes), phaseTime));
+			json += buffer;
+		}
+
+		json += "],\"slowestFiles\":[";
+		std::vector<FileStats> slowest = GetSlowestFiles(slowestCount);
+		for (size_t i = 0; i < slowest.size(); ++i)
+		{
+			const FileStats& file = slowest[i];
+			json += i == 0 ? "{\"file\":" : ",{\"file\":";
+			AppendJsonString(json, file.File);
+			snprintf(buffer, sizeof(buffer), ",\"bytes\":%zu,\"parseAllocations\":%llu,\"timeMs\":%.3f", file.Bytes, static_cast<unsigned long long>(file.ParseAllocations), ToMilliseconds(file.GetTotalTime()));
+			json += buffer;
+			for (size_t phase = 0; phase < PhaseCount; ++phase)
+			{
+				json += ',';
+				std::string name = ReflectPhaseToString(static_cast<EReflectPhase>(phase));
+				name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+				AppendJsonString(json, name + "Ms");
+				snprintf(buffer, sizeof(buffer), ":%.3f", ToMilliseconds(file.PhaseTime[phase]));
+				json += buffer;
+			}
+			json += '}';
+		}
+
+		json += "],\"slowestContainers\":[";
+		std::vector<ContainerStats> slowestContainers = GetSlowestContainers(slowestCount);
+		for (size_t i = 0; i < slowestContainers.size(); ++i)
+		{
+			const ContainerStats& container = slowestContainers[i];
+			json += i == 0 ? "{\"container\":" : ",{\"container\":";
+			AppendJsonString(json, container.Container);
+			json += ",\"file\":";
+			AppendJsonString(json, container.File);
+			snprintf(buffer, sizeof(buffer), ",\"parseTimeMs\":%.3f,\"bytesScanned\":%zu,\"allocations\":%llu}",
+				ToMilliseconds(container.ParseTime), container.BytesScanned, static_cast<unsigned long long>(container.Allocations));
+			json += buffer;
+		}
+		json += "]}";
+		return json;
+	}
+}
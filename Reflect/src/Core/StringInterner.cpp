@@ -0,0 +1,97 @@
+#include "Core/StringInterner.h"
+#include "Core/Hash.h"
+#include <algorithm>
+
+namespace Reflect
+{
+	InternedString::InternedString(std::string_view str)
+		: m_string(StringInterner::Get().Intern(str).m_string)
+	{ }
+
+	StringInterner& StringInterner::Get()
+	{
+		static StringInterner instance;
+		return instance;
+	}
+
+	InternedString StringInterner::Intern(std::string_view str)
+	{
+		if (str.empty())
+		{
+			return InternedString();
+		}
+
+		// The low bits pick the slot inside the shard's table, so use the high ones to pick the shard.
+		const uint64_t hash = Hash::HashBytes(str.data(), str.size());
+		Shard& shard = m_shards[(hash >> 60) % ShardCount];
+		std::lock_guard lock(shard.Mutex);
+		if ((shard.Count + 1) * 2 > shard.Table.size())
+		{
+			Grow(shard);
+		}
+
+		const size_t mask = shard.Table.size() - 1;
+		size_t index = static_cast<size_t>(hash) & mask;
+		while (shard.Table[index].String != nullptr)
+		{
+			const InternedString stored(shard.Table[index].String, true);
+			if (shard.Table[index].Hash == hash && stored.Get() == str)
+			{
+				return stored;
+			}
+			index = (index + 1) & mask;
+		}
+
+		const uint32_t length = static_cast<uint32_t>(str.size());
+		char* memory = static_cast<char*>(shard.Strings.Allocate(sizeof(length) + str.size() + 1, alignof(uint32_t)));
+		memcpy(memory, &length, sizeof(length));
+		memcpy(memory + sizeof(length), str.data(), str.size());
+		memory[sizeof(length) + str.size()] = '\0';
+
+		shard.Table[index] = { hash, memory + sizeof(length) };
+		++shard.Count;
+		shard.Bytes += str.size();
+		return InternedString(shard.Table[index].String, true);
+	}
+
+	void StringInterner::Grow(Shard& shard)
+	{
+		std::vector<Slot> table(std::max<size_t>(shard.Table.size() * 2, 64), Slot{ 0, nullptr });
+		const size_t mask = table.size() - 1;
+		for (const Slot& slot : shard.Table)
+		{
+			if (slot.String != nullptr)
+			{
+				size_t index = static_cast<size_t>(slot.Hash) & mask;
+				while (table[index].String != nullptr)
+				{
+					index = (index + 1) & mask;
+				}
+				table[index] = slot;
+			}
+		}
+		shard.Table = std::move(table);
+	}
+
+	size_t StringInterner::GetStringCount() const
+	{
+		size_t count = 0;
+		for (const Shard& shard : m_shards)
+		{
+			std::lock_guard lock(shard.Mutex);
+			count += shard.Count;
+		}
+		return count;
+	}
+
+	size_t StringInterner::GetTotalBytes() const
+	{
+		size_t bytes = 0;
+		for (const Shard& shard : m_shards)
+		{
+			std::lock_guard lock(shard.Mutex);
+			bytes += shard.Bytes;
+		}
+		return bytes;
+	}
+}
@@ -0,0 +1,88 @@
+#include "Core/ThreadPool.h"
+#include "Instrumentor.h"
+#include <algorithm>
+#include <stdlib.h>
+
+namespace Reflect
+{
+	ThreadPool::ThreadPool(size_t threadCount, const std::string& name)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+		m_threads.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			m_threads.emplace_back(&ThreadPool::WorkerThread, this, i, name);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		Wait();
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+		}
+		m_taskAvailable.notify_all();
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	void ThreadPool::Submit(std::function<void()> task)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_tasks.push_back(std::move(task));
+			++m_pendingTasks;
+		}
+		m_taskAvailable.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock lock(m_mutex);
+		m_tasksFinished.wait(lock, [this]() { return m_pendingTasks == 0; });
+	}
+
+	size_t ThreadPool::ThreadCountFromString(const std::string& value)
+	{
+		const long count = strtol(value.c_str(), nullptr, 10);
+		return count > 0 ? static_cast<size_t>(count) : 0;
+	}
+
+	void ThreadPool::WorkerThread(size_t index, std::string name)
+	{
+		REFLECT_PROFILE_THREAD(name + " " + std::to_string(index));
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock lock(m_mutex);
+				m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+				if (m_tasks.empty())
+				{
+					// Only empty when stopping.
+					return;
+				}
+				task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+			}
+
+			task();
+
+			bool finished = false;
+			{
+				std::lock_guard lock(m_mutex);
+				finished = --m_pendingTasks == 0;
+			}
+			if (finished)
+			{
+				m_tasksFinished.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#include "Core/TypeRegistry.h"
+#include <algorithm>
+#include <string.h>
+
+namespace Reflect
+{
+	TypeInfo::TypeInfo(const char* name, TypeId typeId, std::size_t typeSize, std::size_t typeAlignment, std::vector<std::string> inheritance,
+		ReflectMemberProp* members, std::size_t memberCount,
+		ReflectFunctionProp* functions, std::size_t functionCount,
+		ConstructFunc constructFunc, DestructFunc destructFunc,
+		ReflectMemberProp* allMembers, std::size_t allMemberCount,
+		ReflectFunctionProp* allFunctions, std::size_t allFunctionCount)
+		: m_name(name)
+		, m_typeId(typeId)
+		, m_typeSize(typeSize)
+		, m_typeAlignment(typeAlignment)
+		, m_inheritance(std::move(inheritance))
+		, m_members({ members, members + memberCount })
+		, m_functions({ functions, functions + functionCount })
+		, m_allMembers(allMembers ? TypeInfoRange<ReflectMemberProp>{ allMembers, allMembers + allMemberCount } : m_members)
+		, m_allFunctions(allFunctions ? TypeInfoRange<ReflectFunctionProp>{ allFunctions, allFunctions + allFunctionCount } : m_functions)
+		, m_hasResolvedBases(allMembers != nullptr || allFunctions != nullptr)
+		, m_constructFunc(constructFunc)
+		, m_destructFunc(destructFunc)
+	{
+		TypeRegistry::Get().Register(*this);
+	}
+
+	TypeInfo::~TypeInfo()
+	{
+		TypeRegistry::Get().Unregister(*this);
+	}
+
+	const ReflectMemberProp* TypeInfo::FindMember(std::string_view memberName) const
+	{
+		for (const auto& member : m_members)
+		{
+			if (memberName == member.Name)
+			{
+				return &member;
+			}
+		}
+		return nullptr;
+	}
+
+	const ReflectFunctionProp* TypeInfo::FindFunction(std::string_view functionName) const
+	{
+		for (const auto& func : m_functions)
+		{
+			if (functionName == func.Name)
+			{
+				return &func;
+			}
+		}
+		return nullptr;
+	}
+
+	TypeRegistry& TypeRegistry::Get()
+	{
+		static TypeRegistry instance;
+		return instance;
+	}
+
+	void TypeRegistry::Register(const TypeInfo& typeInfo)
+	{
+		auto itr = m_types.find(typeInfo.GetTypeId());
+		if (itr != m_types.end())
+		{
+			if (strcmp(itr->second->GetName(), typeInfo.GetName()) != 0)
+			{
+				Log_Error("[TypeRegistry::Register] Type id collision between '%s' and '%s'.", itr->second->GetName(), typeInfo.GetName());
+			}
+			else
+			{
+				Log_Error("[TypeRegistry::Register] Type '%s' has already been registered.", typeInfo.GetName());
+			}
+			return;
+		}
+
+		m_types[typeInfo.GetTypeId()] = &typeInfo;
+		m_typeList.push_back(&typeInfo);
+	}
+
+	void TypeRegistry::Unregister(const TypeInfo& typeInfo)
+	{
+		auto itr = m_types.find(typeInfo.GetTypeId());
+		if (itr != m_types.end() && itr->second == &typeInfo)
+		{
+			m_types.erase(itr);
+			m_typeList.erase(std::find(m_typeList.begin(), m_typeList.end(), &typeInfo));
+		}
+	}
+
+	const TypeInfo* TypeRegistry::Find(TypeId typeId) const
+	{
+		auto itr = m_types.find(typeId);
+		return itr != m_types.end() ? itr->second : nullptr;
+	}
+}
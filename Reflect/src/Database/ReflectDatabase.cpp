@@ -0,0 +1,578 @@
+#include "Database/ReflectDatabase.h"
+#include "Instrumentor.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Reflect
+{
+	// Size of the blocks GetFileParsedData allocates the model of a file in.
+	constexpr size_t ModelArenaBlockSize = 16 * 1024;
+
+	namespace DatabaseFormat
+	{
+		std::string NormaliseSourcePath(const std::string& filePath)
+		{
+			return std::filesystem::path(filePath).lexically_normal().generic_u8string();
+		}
+
+		/// <summary>
+		/// Build the sections of a database in memory.
+		/// </summary>
+		class Builder
+		{
+		public:
+			StringRef AddString(const std::string& str)
+			{
+				auto itr = m_stringRefs.find(str);
+				if (itr != m_stringRefs.end())
+				{
+					return itr->second;
+				}
+
+				const uint32_t length = static_cast<uint32_t>(str.size());
+				m_strings.append(reinterpret_cast<const char*>(&length), sizeof(length));
+				const StringRef ref = static_cast<StringRef>(m_strings.size());
+				m_strings.append(str);
+				m_strings += '\0';
+				m_stringRefs.emplace(str, ref);
+				return ref;
+			}
+
+			StringRef AddString(InternedString str)
+			{
+				// The model's strings are interned, so most are found by their handle without hashing the characters.
+				auto itr = m_internedRefs.find(str);
+				if (itr != m_internedRefs.end())
+				{
+					return itr->second;
+				}
+				const StringRef ref = AddString(std::string(str.Get()));
+				m_internedRefs.emplace(str, ref);
+				return ref;
+			}
+
+			template<typename Strings>
+			Range AddStringList(const Strings& strings)
+			{
+				Range range = { static_cast<uint32_t>(m_stringLists.size()), static_cast<uint32_t>(strings.size()) };
+				for (const auto& str : strings)
+				{
+					m_stringLists.push_back(AddString(str));
+				}
+				return range;
+			}
+
+			TypeName AddTypeName(const ReflectTypeNameData& data, InternedString name)
+			{
+				TypeName typeName = {};
+				typeName.Type = AddString(data.Type);
+				typeName.Name = AddString(name);
+				typeName.TypeSize = data.TypeSize;
+				typeName.ValueType = static_cast<uint8_t>(data.ReflectValueType);
+				typeName.Modifier = static_cast<uint8_t>(data.ReflectModifier);
+				typeName.IsConst = data.IsConst ? 1 : 0;
+				typeName.Props = AddStringList(data.ContainerProps);
+				return typeName;
+			}
+
+			void AddFile(const FileParsedData& data, const std::string& sourcePath)
+			{
+				File file = {};
+				file.SourcePath = AddString(sourcePath);
+				file.FilePath = AddString(data.FilePath);
+				file.FileName = AddString(data.FileName);
+				file.FileExtension = AddString(data.FileExtension);
+				file.GeneratedBodyLineOffset = data.GeneratedBodyLineOffset;
+				file.CPPIncludes = AddStringList(data.CPPIncludes);
+				file.Containers = { static_cast<uint32_t>(m_containers.size()), static_cast<uint32_t>(data.ReflectData.size()) };
+
+				for (const ReflectContainerData& containerData : data.ReflectData)
+				{
+					Container container = {};
+					container.Type = AddTypeName(containerData, containerData.Name);
+					container.PrettyName = AddString(containerData.PrettyName);
+					container.File = static_cast<uint32_t>(m_files.size());
+					container.GeneratedBodyLine = containerData.ReflectGenerateBodyLine;
+					container.ReflectType = static_cast<uint8_t>(containerData.ReflectType);
+					container.Inheritance = AddStringList(containerData.Inheritance);
+					std::vector<std::string> inheritanceAccess;
+					for (EReflectAccess access : containerData.InheritanceAccess)
+					{
+						inheritanceAccess.push_back(ReflectAccessToString(access));
+					}
+					container.InheritanceAccess = AddStringList(inheritanceAccess);
+
+					container.Members = { static_cast<uint32_t>(m_members.size()), static_cast<uint32_t>(containerData.Members.size()) };
+					for (const ReflectMemberData& member : containerData.Members)
+					{
+						m_members.push_back(AddTypeName(member, member.Name));
+					}
+
+					container.Functions = { static_cast<uint32_t>(m_functions.size()), static_cast<uint32_t>(containerData.Functions.size()) };
+					for (const ReflectFunctionData& functionData : containerData.Functions)
+					{
+						Function function = {};
+						function.Return = AddTypeName(functionData, functionData.Name);
+						function.Parameters = { static_cast<uint32_t>(m_parameters.size()), static_cast<uint32_t>(functionData.Parameters.size()) };
+						for (const ReflectTypeNameData& parameter : functionData.Parameters)
+						{
+							m_parameters.push_back(AddTypeName(parameter, parameter.Name));
+						}
+						m_functions.push_back(function);
+					}
+
+					m_containerIndex.push_back({ Hash::HashString(containerData.Name), static_cast<uint32_t>(m_containers.size()), 0 });
+					m_containers.push_back(container);
+				}
+				m_files.push_back(file);
+			}
+
+			/// <summary>
+			/// Lay out the header and sections. Returns false if the database is too big for 32 bit offsets.
+			/// </summary>
+			bool Build(std::string& out)
+			{
+				std::stable_sort(m_containerIndex.begin(), m_containerIndex.end(), [](const ContainerIndexEntry& a, const ContainerIndexEntry& b)
+				{
+					return a.NameHash < b.NameHash;
+				});
+
+				Header header = {};
+				memcpy(header.Magic, Magic, sizeof(Magic));
+				header.Version = Version;
+				header.ByteOrder = ByteOrderMark;
+				header.HeaderSize = sizeof(Header);
+
+				out.assign(sizeof(Header), '\0');
+				AppendSection(out, header, Section::Strings, m_strings.data(), m_strings.size(), m_strings.size());
+				AppendSection(out, header, Section::StringLists, m_stringLists);
+				AppendSection(out, header, Section::Files, m_files);
+				AppendSection(out, header, Section::Containers, m_containers);
+				AppendSection(out, header, Section::Members, m_members);
+				AppendSection(out, header, Section::Functions, m_functions);
+				AppendSection(out, header, Section::Parameters, m_parameters);
+				AppendSection(out, header, Section::ContainerIndex, m_containerIndex);
+				if (out.size() > UINT32_MAX)
+				{
+					return false;
+				}
+
+				header.FileSize = out.size();
+				memcpy(out.data(), &header, sizeof(header));
+				return true;
+			}
+
+		private:
+			template<typename T>
+			static void AppendSection(std::string& out, Header& header, Section section, const std::vector<T>& records)
+			{
+				AppendSection(out, header, section, records.data(), records.size() * sizeof(T), records.size());
+			}
+
+			static void AppendSection(std::string& out, Header& header, Section section, const void* data, size_t size, size_t count)
+			{
+				out.resize((out.size() + SectionAlignment - 1) / SectionAlignment * SectionAlignment, '\0');
+				header.Sections[static_cast<size_t>(section)] = { static_cast<uint32_t>(out.size()), static_cast<uint32_t>(count) };
+				out.append(static_cast<const char*>(data), size);
+			}
+
+		private:
+			std::string m_strings;
+			std::unordered_map<std::string, StringRef> m_stringRefs;
+			std::unordered_map<InternedString, StringRef> m_internedRefs;
+			std::vector<StringRef> m_stringLists;
+			std::vector<File> m_files;
+			std::vector<Container> m_containers;
+			std::vector<TypeName> m_members;
+			std::vector<Function> m_functions;
+			std::vector<TypeName> m_parameters;
+			std::vector<ContainerIndexEntry> m_containerIndex;
+		};
+	}
+
+	void ReflectDatabaseWriter::AddFile(FileParsedData data)
+	{
+		data.Data.clear();
+		data.Data.shrink_to_fit();
+
+		std::lock_guard lock(m_mutex);
+		m_files.push_back(std::move(data));
+	}
+
+	bool ReflectDatabaseWriter::Write(const std::string& filePath)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		std::lock_guard lock(m_mutex);
+
+		// Sorted by path so FindFile can binary search, and so the file is the same whichever order the files were parsed in.
+		std::vector<std::pair<std::string, const FileParsedData*>> files;
+		files.reserve(m_files.size());
+		for (const FileParsedData& file : m_files)
+		{
+			files.emplace_back(DatabaseFormat::NormaliseSourcePath(file.FilePath + "/" + file.FileName + file.FileExtension), &file);
+		}
+		std::sort(files.begin(), files.end(), [](const auto& a, const auto& b)
+		{
+			return a.first < b.first;
+		});
+
+		DatabaseFormat::Builder builder;
+		for (const auto& [sourcePath, file] : files)
+		{
+			builder.AddFile(*file, sourcePath);
+		}
+		std::string data;
+		if (!builder.Build(data))
+		{
+			Log_Error("[ReflectDatabaseWriter::Write] Database '%s' is larger than 4GB.", filePath.c_str());
+			return false;
+		}
+
+		const std::string tempPath = filePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open() || !file.write(data.data(), data.size()))
+			{
+				Log_Error("[ReflectDatabaseWriter::Write] File '%s' could not be written.", tempPath.c_str());
+				return false;
+			}
+		}
+
+		std::error_code err;
+		std::filesystem::rename(tempPath, filePath, err);
+		if (err)
+		{
+			Log_Error("[ReflectDatabaseWriter::Write] File '%s' could not be replaced: %s", filePath.c_str(), err.message().c_str());
+			std::filesystem::remove(tempPath, err);
+			return false;
+		}
+		return true;
+	}
+
+	ReflectDatabase::ReflectDatabase()
+	{ }
+
+	ReflectDatabase::~ReflectDatabase()
+	{
+		Close();
+	}
+
+	bool ReflectDatabase::Open(const std::string& filePath)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		Close();
+		m_error.clear();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			m_error = "Could not open '" + filePath + "'.";
+			return false;
+		}
+		LARGE_INTEGER fileSize = {};
+		GetFileSizeEx(file, &fileSize);
+		if (static_cast<uint64_t>(fileSize.QuadPart) < sizeof(DatabaseFormat::Header))
+		{
+			CloseHandle(file);
+			m_error = "'" + filePath + "' is not a reflection database.";
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		const void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr)
+		{
+			if (mapping != nullptr)
+			{
+				CloseHandle(mapping);
+			}
+			m_error = "Could not map '" + filePath + "'.";
+			return false;
+		}
+		m_data = static_cast<const char*>(view);
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		m_mapping = mapping;
+#else
+		const int file = open(filePath.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			m_error = "Could not open '" + filePath + "'.";
+			return false;
+		}
+		struct stat fileStat = {};
+		if (fstat(file, &fileStat) != 0 || static_cast<uint64_t>(fileStat.st_size) < sizeof(DatabaseFormat::Header))
+		{
+			close(file);
+			m_error = "'" + filePath + "' is not a reflection database.";
+			return false;
+		}
+		void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (view == MAP_FAILED)
+		{
+			m_error = "Could not map '" + filePath + "'.";
+			return false;
+		}
+		m_data = static_cast<const char*>(view);
+		m_size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+		if (!Validate())
+		{
+			m_error = "'" + filePath + "': " + m_error;
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void ReflectDatabase::Close()
+	{
+		if (m_data == nullptr)
+		{
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+#else
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+		m_mapping = nullptr;
+	}
+
+	std::string_view ReflectDatabase::GetString(DatabaseFormat::StringRef ref) const
+	{
+		const char* str = GetSection<char>(DatabaseFormat::Section::Strings).Data + ref;
+		uint32_t length = 0;
+		memcpy(&length, str - sizeof(length), sizeof(length));
+		return std::string_view(str, length);
+	}
+
+	const DatabaseFormat::Container* ReflectDatabase::FindContainer(std::string_view name) const
+	{
+		const View<DatabaseFormat::ContainerIndexEntry> index = GetSection<DatabaseFormat::ContainerIndexEntry>(DatabaseFormat::Section::ContainerIndex);
+		const uint64_t hash = Hash::HashString(name);
+		const DatabaseFormat::ContainerIndexEntry* itr = std::lower_bound(index.begin(), index.end(), hash, [](const DatabaseFormat::ContainerIndexEntry& entry, uint64_t value)
+		{
+			return entry.NameHash < value;
+		});
+		for (; itr != index.end() && itr->NameHash == hash; ++itr)
+		{
+			const DatabaseFormat::Container& container = GetContainers()[itr->Container];
+			if (GetString(container.Type.Name) == name)
+			{
+				return &container;
+			}
+		}
+		return nullptr;
+	}
+
+	const DatabaseFormat::File* ReflectDatabase::FindFile(const std::string& filePath) const
+	{
+		const std::string sourcePath = DatabaseFormat::NormaliseSourcePath(filePath);
+		const View<DatabaseFormat::File> files = GetFiles();
+		const DatabaseFormat::File* itr = std::lower_bound(files.begin(), files.end(), sourcePath, [this](const DatabaseFormat::File& file, const std::string& value)
+		{
+			return GetString(file.SourcePath) < value;
+		});
+		return itr != files.end() && GetString(itr->SourcePath) == sourcePath ? itr : nullptr;
+	}
+
+	void ReflectDatabase::GetFileParsedData(const DatabaseFormat::File& file, FileParsedData& data) const
+	{
+		data = {};
+		data.Arena = std::make_shared<ArenaAllocator>(ModelArenaBlockSize);
+		data.ReflectData = ModelVector<ReflectContainerData>(data.Arena.get());
+		data.Cursor = 0;
+		data.FilePath = GetString(file.FilePath);
+		data.FileName = GetString(file.FileName);
+		data.FileExtension = GetString(file.FileExtension);
+		data.GeneratedBodyLineOffset = file.GeneratedBodyLineOffset;
+		data.CPPIncludes = GetStringList(file.CPPIncludes);
+
+		const View<DatabaseFormat::Container> containers = GetContainers(file);
+		data.ReflectData.reserve(containers.size());
+		for (const DatabaseFormat::Container& container : containers)
+		{
+			ReflectContainerData& containerData = data.ReflectData.emplace_back(data.Arena.get());
+			static_cast<ReflectTypeNameData&>(containerData) = GetTypeNameData(container.Type, data.Arena.get());
+			static_cast<ReflectTypeNameData&>(containerData).Name = InternedString();
+			containerData.Name = GetString(container.Type.Name);
+			containerData.PrettyName = GetString(container.PrettyName);
+			containerData.Inheritance.reserve(container.Inheritance.Count);
+			for (DatabaseFormat::StringRef ref : GetStrings(container.Inheritance))
+			{
+				containerData.Inheritance.emplace_back(GetString(ref));
+			}
+			containerData.InheritanceAccess.reserve(container.InheritanceAccess.Count);
+			for (DatabaseFormat::StringRef ref : GetStrings(container.InheritanceAccess))
+			{
+				containerData.InheritanceAccess.push_back(StringToReflectAccess(std::string(GetString(ref))));
+			}
+			containerData.ReflectType = static_cast<EReflectType>(container.ReflectType);
+			containerData.ReflectGenerateBodyLine = container.GeneratedBodyLine;
+
+			for (const DatabaseFormat::TypeName& member : GetMembers(container))
+			{
+				ReflectMemberData& memberData = containerData.Members.emplace_back(data.Arena.get());
+				static_cast<ReflectTypeNameData&>(memberData) = GetTypeNameData(member, data.Arena.get());
+			}
+			for (const DatabaseFormat::Function& function : GetFunctions(container))
+			{
+				ReflectFunctionData& functionData = containerData.Functions.emplace_back(data.Arena.get());
+				static_cast<ReflectTypeNameData&>(functionData) = GetTypeNameData(function.Return, data.Arena.get());
+				for (const DatabaseFormat::TypeName& parameter : GetParameters(function))
+				{
+					functionData.Parameters.push_back(GetTypeNameData(parameter, data.Arena.get()));
+				}
+			}
+		}
+	}
+
+	bool ReflectDatabase::Validate()
+	{
+		using namespace DatabaseFormat;
+
+		const Header& header = GetHeader();
+		if (memcmp(header.Magic, Magic, sizeof(Magic)) != 0)
+		{
+			m_error = "Not a reflection database.";
+			return false;
+		}
+		if (header.ByteOrder != ByteOrderMark)
+		{
+			m_error = "Written on a machine with a different byte order.";
+			return false;
+		}
+		if (header.Version != Version || header.HeaderSize != sizeof(Header))
+		{
+			m_error = "Unsupported database version " + std::to_string(header.Version) + ", expected " + std::to_string(Version) + ".";
+			return false;
+		}
+		if (header.FileSize != m_size)
+		{
+			m_error = "File size doesn't match the header, the file is truncated.";
+			return false;
+		}
+
+		const size_t recordSizes[] = { 1, sizeof(StringRef), sizeof(File), sizeof(Container), sizeof(TypeName), sizeof(Function), sizeof(TypeName), sizeof(ContainerIndexEntry) };
+		static_assert(sizeof(recordSizes) / sizeof(recordSizes[0]) == static_cast<size_t>(Section::Count), "Missing section record size.");
+		for (size_t i = 0; i < static_cast<size_t>(Section::Count); ++i)
+		{
+			const SectionEntry& entry = header.Sections[i];
+			if (entry.Offset % SectionAlignment != 0 || entry.Offset < sizeof(Header) || static_cast<uint64_t>(entry.Offset) + static_cast<uint64_t>(entry.Count) * recordSizes[i] > m_size)
+			{
+				m_error = "Section " + std::to_string(i) + " is out of bounds.";
+				return false;
+			}
+		}
+
+		// Every reference is checked once here so the accessors don't need to.
+		const View<char> strings = GetSection<char>(Section::Strings);
+		auto validString = [&strings](StringRef ref)
+		{
+			if (ref < sizeof(uint32_t) || ref >= strings.size())
+			{
+				return false;
+			}
+			uint32_t length = 0;
+			memcpy(&length, strings.Data + ref - sizeof(length), sizeof(length));
+			return static_cast<uint64_t>(ref) + length < strings.size() && strings[ref + length] == '\0';
+		};
+		auto validRange = [&header](Section section, Range range)
+		{
+			return static_cast<uint64_t>(range.First) + range.Count <= header.Sections[static_cast<size_t>(section)].Count;
+		};
+		auto validTypeName = [&](const TypeName& typeName)
+		{
+			return validString(typeName.Type) && validString(typeName.Name) && validRange(Section::StringLists, typeName.Props)
+				&& typeName.ValueType <= static_cast<uint8_t>(EReflectValueType::PointerReference)
+				&& typeName.Modifier <= static_cast<uint8_t>(EReflectValueModifier::Virtual);
+		};
+
+		bool valid = true;
+		for (StringRef ref : GetSection<StringRef>(Section::StringLists))
+		{
+			valid &= validString(ref);
+		}
+		for (const File& file : GetFiles())
+		{
+			valid &= validString(file.SourcePath) && validString(file.FilePath) && validString(file.FileName) && validString(file.FileExtension)
+				&& validRange(Section::StringLists, file.CPPIncludes) && validRange(Section::Containers, file.Containers);
+		}
+		for (const Container& container : GetContainers())
+		{
+			valid &= validTypeName(container.Type) && validString(container.PrettyName) && container.File < GetFiles().size()
+				&& container.ReflectType <= static_cast<uint8_t>(EReflectType::Unknown) && validRange(Section::StringLists, container.Inheritance)
+				&& validRange(Section::StringLists, container.InheritanceAccess) && container.InheritanceAccess.Count == container.Inheritance.Count
+				&& validRange(Section::Members, container.Members) && validRange(Section::Functions, container.Functions);
+		}
+		for (const TypeName& member : GetSection<TypeName>(Section::Members))
+		{
+			valid &= validTypeName(member);
+		}
+		for (const Function& function : GetSection<Function>(Section::Functions))
+		{
+			valid &= validTypeName(function.Return) && validRange(Section::Parameters, function.Parameters);
+		}
+		for (const TypeName& parameter : GetSection<TypeName>(Section::Parameters))
+		{
+			valid &= validTypeName(parameter);
+		}
+		for (const ContainerIndexEntry& entry : GetSection<ContainerIndexEntry>(Section::ContainerIndex))
+		{
+			valid &= entry.Container < GetContainers().size();
+		}
+		if (!valid)
+		{
+			m_error = "Corrupt database, a record points outside of its section.";
+		}
+		return valid;
+	}
+
+	ReflectTypeNameData ReflectDatabase::GetTypeNameData(const DatabaseFormat::TypeName& typeName, ArenaAllocator* arena) const
+	{
+		ReflectTypeNameData data(arena);
+		data.Type = GetString(typeName.Type);
+		data.Name = GetString(typeName.Name);
+		data.TypeSize = typeName.TypeSize;
+		data.ReflectValueType = static_cast<EReflectValueType>(typeName.ValueType);
+		data.ReflectModifier = static_cast<EReflectValueModifier>(typeName.Modifier);
+		data.IsConst = typeName.IsConst != 0;
+		data.ContainerProps.reserve(typeName.Props.Count);
+		for (DatabaseFormat::StringRef ref : GetStrings(typeName.Props))
+		{
+			data.ContainerProps.emplace_back(GetString(ref));
+		}
+		return data;
+	}
+
+	std::vector<std::string> ReflectDatabase::GetStringList(DatabaseFormat::Range range) const
+	{
+		std::vector<std::string> strings;
+		strings.reserve(range.Count);
+		for (DatabaseFormat::StringRef ref : GetStrings(range))
+		{
+			strings.emplace_back(GetString(ref));
+		}
+		return strings;
+	}
+}
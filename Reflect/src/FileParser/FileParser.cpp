@@ -1,11 +1,15 @@
 #include "FileParser/FileParser.h"
 #include "FileParser/FileParserKeyWords.h"
+#include "FileParser/HeaderCache.h"
+#include "FileParser/InheritanceResolver.h"
+#include "Core/RunStats.h"
 #include "Instrumentor.h"
 #include <sstream>
 #include <vector>
 #include <iostream>
 #include <filesystem>
 #include <stack>
+#include <algorithm>
 #include <assert.h>
 #include <string.h>
 
@@ -17,6 +21,10 @@ namespace Reflect
 	const std::vector<char> generalEndChars = { ' ', '(', '=', ';', ':'};
 	const std::vector<char> functionStartChars = { '(' };
 	const std::vector<char> memberStartChars = { '=', ';' };
+	const std::vector<char> memberNameEndChars = { '\n', '\t', '\r', ' ', '*', '&' };
+
+	// Size of the blocks the parsed model of a file is allocated in, relative to the size of the file.
+	constexpr size_t ModelArenaMinBlockSize = 4 * 1024;
 
 	FileParser::FileParser()
 	{ }
@@ -29,17 +37,51 @@ namespace Reflect
 		REFLECT_PROFILE_FUNCTION();
 
 		m_filesParsed.clear();
-		m_filesToRemove.clear();
+		SetOptions(options);
+
+		// Each header is parsed once, whether it is in the directory or only included by one which is.
+		HeaderCache headers(*this);
+		InheritanceResolver resolver(headers);
+		const std::vector<std::string> filePaths = CollectFiles(directory);
+		for (const std::string& filePath : filePaths)
+		{
+			if (FileParsedData* data = headers.Parse(filePath))
+			{
+				resolver.Resolve(*data);
+			}
+			REFLECT_PROFILE_COUNTER("Files Parsed", &filePath - filePaths.data() + 1);
+		}
+
+		for (const std::string& filePath : filePaths)
+		{
+			FileParsedData data;
+			if (headers.Take(filePath, data))
+			{
+				m_filesParsed.push_back(std::move(data));
+			}
+		}
+	}
+
+	void FileParser::SetOptions(const ReflectAddtionalOptions& options)
+	{
 		m_options = options;
+		m_parseWarnTime = static_cast<int64_t>(atof(m_options.options[Reflect_CMD_Option_Parse_Warn_Ms].c_str()) * 1e6);
+	}
+
+	std::vector<std::string> FileParser::CollectFiles(const std::string& directory)
+	{
+		REFLECT_PROFILE_FUNCTION();
 
+		std::vector<std::string> files;
 		std::filesystem::path dirPath(directory);
 		std::error_code err;
 		if (!std::filesystem::is_directory(dirPath, err))
 		{
-			std::cout << err.message() << '\n';
-			return;
+			Log_Error("[FileParser::CollectFiles] '%s': %s", directory.c_str(), err.message().c_str());
+			return files;
 		}
 
+		int64_t walkStart = RunStats::Now();
 		for (const auto& f : std::filesystem::recursive_directory_iterator(directory))
 		{
 			std::string filePath = f.path().u8string();
@@ -48,39 +90,79 @@ namespace Reflect
 				CheckExtension(filePath, { ".h", ".hpp" }) &&
 				!CheckIfAutoGeneratedFile(filePath))
 			{
-				// TODO thread this. We could load files on more than one thread to speed
-				// this up.
-				std::cout << "Parsing: " << filePath << std::endl;
-				std::ifstream file = OpenFile(filePath);
-				FileParsedData data = LoadFile(file);
-				data.FileName = f.path().filename().u8string().substr(0, f.path().filename().u8string().find_last_of('.'));
-				data.FilePath = f.path().parent_path().u8string();
-				m_filesParsed.push_back(data);
-				CloseFile(file);
+				files.push_back(std::move(filePath));
 			}
 		}
+		RunStats::Get().AddPhaseTime(EReflectPhase::DirectoryWalk, RunStats::Now() - walkStart);
+		return files;
+	}
 
+	std::vector<std::string> FileParser::CollectFilesFromList(const std::string& listPath)
+	{
+		REFLECT_PROFILE_FUNCTION();
 
-		// All files have been loaded.
-		// Now we need to parse them to find all the information we want from them.
-		// TODO: this could also be threaded.
-		for (auto& file : m_filesParsed)
+		std::vector<std::string> files;
+		std::ifstream listFile;
+		if (listPath != "-")
 		{
-			if (!ParseFile(file))
+			listFile.open(listPath);
+			if (!listFile.is_open())
 			{
-				m_filesToRemove.push_back(file.FileName);
+				Log_Error("[FileParser::CollectFilesFromList] File list '%s' could not be opened.", listPath.c_str());
+				return files;
 			}
 		}
+		std::istream& list = listPath == "-" ? std::cin : listFile;
 
-		for (auto const& fileToRemove : m_filesToRemove)
+		int64_t walkStart = RunStats::Now();
+		std::string line;
+		while (std::getline(list, line))
 		{
-			auto itr = std::find_if(m_filesParsed.begin(), m_filesParsed.end(), [fileToRemove](FileParsedData const& data)
+			// Lists written on Windows end their lines with "\r\n", and paths may be quoted.
+			const size_t start = line.find_first_not_of(" \t\r\"");
+			if (start == std::string::npos)
+			{
+				continue;
+			}
+			const std::string filePath = line.substr(start, line.find_last_not_of(" \t\r\"") - start + 1);
+
+			std::error_code err;
+			if (!std::filesystem::is_regular_file(filePath, err))
 			{
-				return fileToRemove == data.FileName;
-			});
-			assert(itr != m_filesParsed.end() && "[FileParser::ParseDirectory] Remove file to parse dose not exists.");
-			m_filesParsed.erase(itr);
+				Log_Error("[FileParser::CollectFilesFromList] '%s' is not a file.", filePath.c_str());
+				continue;
+			}
+			if (filePath.find('.') == std::string::npos ||
+				!CheckExtension(filePath, { ".h", ".hpp" }) ||
+				CheckIfAutoGeneratedFile(filePath))
+			{
+				Log_Verbose("[FileParser::CollectFilesFromList] '%s' is not a header to reflect, skipped.", filePath.c_str());
+				continue;
+			}
+			files.push_back(filePath);
+		}
+		RunStats::Get().AddPhaseTime(EReflectPhase::DirectoryWalk, RunStats::Now() - walkStart);
+		return files;
+	}
+
+	bool FileParser::IsInShard(const std::string& filePath, size_t shardIndex, size_t shardCount)
+	{
+		if (shardCount <= 1)
+		{
+			return true;
 		}
+		// Normalised so "./a/b.h" and "a/b.h" land in the same shard.
+		const std::string path = std::filesystem::path(filePath).lexically_normal().generic_u8string();
+		return Hash::HashString(path) % shardCount == shardIndex;
+	}
+
+	bool FileParser::ParseFile(const std::string& filePath, FileParsedData& fileData)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		Log_Info("Parsing: %s", filePath.c_str());
+		fileData = LoadFile(filePath);
+		return ParseFile(fileData);
 	}
 
 	void FileParser::SetIgnoreStrings(const std::vector<std::string>& ignoreStrings)
@@ -121,16 +203,28 @@ namespace Reflect
 		return filePath.find(ReflectFileGeneratePrefix) != std::string::npos;
 	}
 
-	FileParsedData FileParser::LoadFile(std::ifstream& file)
+	FileParsedData FileParser::LoadFile(const std::string& filePath)
 	{
-		FileParsedData data = {};
+		int64_t loadStart = RunStats::Now();
+		std::ifstream file = OpenFile(filePath);
 
+		FileParsedData data = {};
 		file.seekg(0, std::ios::end);
 		int fileSize = static_cast<int>(file.tellg());
 		file.seekg(0, std::ios::beg);
 		data.Data = std::string(fileSize, '\0');
 		data.Cursor = 0;
 		file.read(&data.Data[0], fileSize);
+		CloseFile(file);
+
+		std::filesystem::path path(filePath);
+		data.FileName = path.filename().u8string().substr(0, path.filename().u8string().find_last_of('.'));
+		data.FilePath = path.parent_path().u8string();
+		data.FileExtension = path.extension().u8string();
+		// Most headers need one block, the model is smaller than the text it is parsed from.
+		data.Arena = std::make_shared<ArenaAllocator>(std::max(ModelArenaMinBlockSize, data.Data.size()));
+		data.ReflectData = ModelVector<ReflectContainerData>(data.Arena.get());
+		RunStats::Get().AddFileTime(data.FilePath + "/" + data.FileName, EReflectPhase::Load, RunStats::Now() - loadStart, data.Data.size());
 
 		return data;
 	}
@@ -139,17 +233,59 @@ namespace Reflect
 	{
 		REFLECT_PROFILE_FUNCTION();
 
+		const std::string statsName = fileData.FilePath + "/" + fileData.FileName;
+		const int64_t fileStart = RunStats::Now();
+		const uint64_t fileAllocations = AllocationCounter::Get();
+
 		bool reflectItem = false;
-		while (ReflectContainerHeader(fileData, RefectStructKey, EReflectType::Struct) || ReflectContainerHeader(fileData, RefectClassKey, EReflectType::Class))
+		while (true)
 		{
+			const int64_t containerStart = RunStats::Now();
+			const uint64_t containerAllocations = AllocationCounter::Get();
+			const int cursorStart = fileData.Cursor;
+			// Take whichever container comes next, so classes and structs can be mixed in any order. Looking for every
+			// REFLECT_STRUCT first would parse the containers out of order and skip the classes before the last struct.
+			const size_t nextContainerCursor = FindNextContainerKey(fileData, fileData.Cursor);
+			const bool isStruct = nextContainerCursor != std::string::npos && fileData.Data.compare(nextContainerCursor, strlen(RefectStructKey), RefectStructKey) == 0;
+			if (!ReflectContainerHeader(fileData, isStruct ? RefectStructKey : RefectClassKey, isStruct ? EReflectType::Struct : EReflectType::Class))
+			{
+				break;
+			}
+
 			ReflectContainer(fileData);
-			GetAllCPPIncludes(fileData);
 			reflectItem = true;
+
+			ContainerStats containerStats;
+			containerStats.File = statsName;
+			containerStats.Container = fileData.ReflectData.back().Name.Get();
+			containerStats.ParseTime = RunStats::Now() - containerStart;
+			containerStats.BytesScanned = static_cast<size_t>(std::max(fileData.Cursor - cursorStart, 0));
+			containerStats.Allocations = AllocationCounter::Get() - containerAllocations;
+			CheckParseTime("Class/struct", containerStats.Container + " (" + statsName + ")", containerStats.ParseTime);
+			RunStats::Get().AddContainer(std::move(containerStats));
 		}
+		if (reflectItem)
+		{
+			GetAllCPPIncludes(fileData);
+		}
+		REFLECT_PROFILE_TAG("Reflected Containers", fileData.ReflectData.size());
+
+		const int64_t parseTime = RunStats::Now() - fileStart;
+		RunStats::Get().AddFileTime(statsName, EReflectPhase::Parse, parseTime);
+		RunStats::Get().AddFileParseAllocations(statsName, AllocationCounter::Get() - fileAllocations);
+		CheckParseTime("File", statsName, parseTime);
 		return reflectItem;
 	}
 
-	bool FileParser::ReflectContainerHeader(FileParsedData& fileData, const std::string& keyword, const EReflectType type)
+	void FileParser::CheckParseTime(const char* kind, const std::string& name, int64_t parseTime) const
+	{
+		if (m_parseWarnTime > 0 && parseTime > m_parseWarnTime)
+		{
+			Log_Warn("[FileParser::ParseFile] %s '%s' took %.2f ms to parse.", kind, name.c_str(), static_cast<double>(parseTime) / 1e6);
+		}
+	}
+
+	bool FileParser::ReflectContainerHeader(FileParsedData& fileData, std::string_view keyword, const EReflectType type)
 	{
 		// Check if we can reflect this class/struct. 
 		int reflectStart = static_cast<int>(fileData.Data.find(keyword, fileData.Cursor));
@@ -159,7 +295,7 @@ namespace Reflect
 			return false;
 		}
 
-		ReflectContainerData containerData = {};
+		ReflectContainerData containerData(fileData.Arena.get());
 
 		containerData.ReflectType = type;
 		fileData.Cursor = reflectStart + static_cast<int>(keyword.length()) + 1;
@@ -202,7 +338,7 @@ namespace Reflect
 			}
 			++fileData.Cursor;
 		}
-		for (const std::string str : m_ignoreStrings)
+		for (const std::string& str : m_ignoreStrings)
 			Util::RemoveString(containerName, str);
 
 		containerData.Name = containerName;
@@ -214,6 +350,35 @@ namespace Reflect
 		bool inheritance = fileData.Data.find(':', fileData.Cursor) < fileData.Data.find('{', fileData.Cursor);
 		if (inheritance)
 		{
+			auto addBase = [&containerData](std::string type)
+			{
+				Util::RemoveCharAll(type, ' ');
+				Util::RemoveCharAll(type, '\n');
+				Util::RemoveCharAll(type, '\t');
+				Util::RemoveCharAll(type, '\r');
+
+				// Without a specifier a class inherits privately and a struct publicly. REFLECT_BASE() is always public.
+				EReflectAccess access = containerData.ReflectType == EReflectType::Class ? EReflectAccess::Private : EReflectAccess::Public;
+				if (type.find(PublicKey) != std::string::npos || type.find("REFLECT_BASE") != std::string::npos)
+				{
+					access = EReflectAccess::Public;
+				}
+				else if (type.find(ProtectedKey) != std::string::npos)
+				{
+					access = EReflectAccess::Protected;
+				}
+				else if (type.find(PrivateKey) != std::string::npos)
+				{
+					access = EReflectAccess::Private;
+				}
+
+				Util::RemoveString(type, PublicKey);
+				Util::RemoveString(type, ProtectedKey);
+				Util::RemoveString(type, PrivateKey);
+				containerData.Inheritance.push_back(type);
+				containerData.InheritanceAccess.push_back(access);
+			};
+
 			FindNextChar(fileData, ':');
 			++fileData.Cursor;
 			std::string type;
@@ -221,11 +386,7 @@ namespace Reflect
 			{
 				if (fileData.Data.at(fileData.Cursor) == ',')
 				{
-					Util::RemoveCharAll(type, ' ');
-					Util::RemoveString(type, PublicKey);
-					Util::RemoveString(type, ProtectedKey);
-					Util::RemoveString(type, PrivateKey);
-					containerData.Inheritance.push_back(type);
+					addBase(std::move(type));
 					type.clear();
 				}
 				else
@@ -234,17 +395,10 @@ namespace Reflect
 				}
 				++fileData.Cursor;
 			}
-			Util::RemoveCharAll(type, ' ');
-			Util::RemoveCharAll(type, '\n');
-			Util::RemoveCharAll(type, '\t');
-			Util::RemoveCharAll(type, '\r');
-			Util::RemoveString(type, PublicKey);
-			Util::RemoveString(type, ProtectedKey);
-			Util::RemoveString(type, PrivateKey);
-			containerData.Inheritance.push_back(type);
+			addBase(std::move(type));
 		}
 
-		fileData.ReflectData.push_back(containerData);
+		fileData.ReflectData.push_back(std::move(containerData));
 		return true;
 	}
 
@@ -254,7 +408,6 @@ namespace Reflect
 
 		// Good, we have a reflected container class/struct.
 		// First find out which it is and verify that we are inheriting from "ReflectObject".
-		std::stack<char> bracketStack;
 		ReflectContainerData& conatinerData = fileData.ReflectData.back();
 
 		int generatedBodyLine = static_cast<int>(fileData.Data.find(ReflectGeneratedBodykey, fileData.GeneratedBodyLineOffset));
@@ -264,16 +417,19 @@ namespace Reflect
 
 		// Set us to the start of the class/struct. We should continue until we find something.
 		char c = FindNextChar(fileData, '{');
-		std::vector<std::string> reflectFlags;
+		ModelVector<InternedString> reflectFlags(fileData.Arena.get());
+		const bool reflectFullExt = m_options.options.at(Reflect_CMD_Option_Reflect_Full_EXT) == "true";
+		size_t nextContainerCursor = 0;
 		while (true)
 		{
 			if (CheckForEndOfFile(fileData, endOfContainerCursor))
 				break;
 
-			if (m_options.options.at(Reflect_CMD_Option_Reflect_Full_EXT) == "true")
+			if (reflectFullExt)
 			{
 				c = FindNextChar(fileData, emptyChars);
-				std::string word = FindNextWord(fileData, generalEndChars);
+				// A view into the file text, only valid while parsing.
+				std::string_view word = FindNextWord(fileData, generalEndChars);
 
 				if (CheckForTypeAlias(word))
 				{
@@ -341,7 +497,7 @@ namespace Reflect
 						ReflectFunctionData funcData = GetFunction(fileData, reflectFlags);
 						if (!funcData.Name.empty())
 						{
-							conatinerData.Functions.push_back(funcData);
+							conatinerData.Functions.push_back(std::move(funcData));
 						}
 					}
 				}
@@ -356,11 +512,19 @@ namespace Reflect
 				if (CheckForEndOfFile(fileData, endOfContainerCursor))
 					break;
 
-				fileData.Cursor = (int)fileData.Data.find(ReflectPropertyKey, fileData.Cursor);
-				if (fileData.Cursor == std::string::npos)
+				// The search for the next REFLECT_PROPERTY stops at the next container, otherwise its properties would be
+				// added to this container too.
+				const size_t propertyCursor = fileData.Data.find(ReflectPropertyKey, fileData.Cursor);
+				if (nextContainerCursor <= static_cast<size_t>(fileData.Cursor))
+				{
+					// Only found again once passed, it is the same for every property in the container.
+					nextContainerCursor = FindNextContainerKey(fileData, fileData.Cursor);
+				}
+				if (propertyCursor == std::string::npos || propertyCursor > nextContainerCursor)
 				{
 					break;
 				}
+				fileData.Cursor = static_cast<int>(propertyCursor);
 
 				fileData.Cursor += (int)strlen(ReflectPropertyKey);
 				reflectFlags = ReflectFlags(fileData);
@@ -399,8 +563,10 @@ namespace Reflect
 		int cursor = fileData.Cursor;
 		char lastCharacter = '\0';
 		char c = '\0';
+#ifdef EXP_PARSER
 		bool foundStartOfContainer = false;
 		std::stack<char> symbols;
+#endif
 		while (true)
 		{
 #ifdef EXP_PARSER
@@ -447,11 +613,16 @@ namespace Reflect
 		return cursor;
 	}
 
-	std::vector<std::string> FileParser::ReflectFlags(FileParsedData& fileData)
+	size_t FileParser::FindNextContainerKey(const FileParsedData& fileData, size_t cursor) const
+	{
+		return std::min(fileData.Data.find(RefectStructKey, cursor), fileData.Data.find(RefectClassKey, cursor));
+	}
+
+	ModelVector<InternedString> FileParser::ReflectFlags(FileParsedData& fileData)
 	{
 		// Get the flags passed though the REFLECT macro.
 		std::string flag;
-		std::vector<std::string> flags;
+		ModelVector<InternedString> flags(fileData.Arena.get());
 
 		if (fileData.Data[fileData.Cursor] == '(')
 		{
@@ -489,47 +660,46 @@ namespace Reflect
 
 	char FileParser::FindNextChar(FileParsedData const& fileData, int& cursor, const std::vector<char>& ignoreChars)
 	{
-		FileParsedData copyFileData = fileData;
-		copyFileData.Cursor = cursor;
-		char c = FindNextChar(copyFileData, ignoreChars);
-		cursor = copyFileData.Cursor;
-		return c;
+		++cursor;
+		while (std::find(ignoreChars.begin(), ignoreChars.end(), fileData.Data[cursor]) != ignoreChars.end())
+		{
+			++cursor;
+		}
+		return fileData.Data[cursor];
 	}
 
 	char FileParser::FindNextChar(FileParsedData& fileData, char charToFind)
 	{
-		char c = fileData.Data[fileData.Cursor];
-		while (c != charToFind)
-		{
-			if (++fileData.Cursor < fileData.Data.size())
-				c = fileData.Data[fileData.Cursor];
-			else
-				break;
-		}
-		return c;
+		fileData.Cursor = FindNextCharCursor(fileData, fileData.Cursor, charToFind);
+		return fileData.Cursor < static_cast<int>(fileData.Data.size()) ? fileData.Data[fileData.Cursor] : '\0';
 	}
 
 	char FileParser::FindNextChar(FileParsedData& fileData, const std::vector<char>& ignoreChars)
 	{
-		++fileData.Cursor;
-		while (std::find(ignoreChars.begin(), ignoreChars.end(), fileData.Data[fileData.Cursor]) != ignoreChars.end())
+		return FindNextChar(fileData, fileData.Cursor, ignoreChars);
+	}
+
+	int FileParser::FindNextCharCursor(const FileParsedData& fileData, int cursor, char charToFind) const
+	{
+		const size_t index = fileData.Data.find(charToFind, cursor);
+		if (index != std::string::npos)
 		{
-			++fileData.Cursor;
+			return static_cast<int>(index);
 		}
-		return fileData.Data[fileData.Cursor];
+		// Not found, stop one past the end.
+		return cursor < static_cast<int>(fileData.Data.size()) ? static_cast<int>(fileData.Data.size()) : cursor + 1;
 	}
 
-	std::string FileParser::FindNextWord(FileParsedData& fileData, const std::vector<char>& endChars)
+	std::string_view FileParser::FindNextWord(FileParsedData& fileData, const std::vector<char>& endChars)
 	{
-		std::string s;
-		s += fileData.Data[fileData.Cursor];
-		char c = FindNextChar(fileData, std::vector<char>());
-		while (std::find(endChars.begin(), endChars.end(), c) == endChars.end())
+		const int start = fileData.Cursor;
+		const int size = static_cast<int>(fileData.Data.size());
+		char c = fileData.Data[++fileData.Cursor];
+		while (fileData.Cursor < size && std::find(endChars.begin(), endChars.end(), c) == endChars.end())
 		{
-			s += c;
-			c = FindNextChar(fileData, std::vector<char>());
+			c = fileData.Data[++fileData.Cursor];
 		}
-		return s;
+		return std::string_view(fileData.Data).substr(start, fileData.Cursor - start);
 	}
 
 	bool FileParser::IsWordReflectKey(std::string_view view)
@@ -554,8 +724,7 @@ namespace Reflect
 	bool FileParser::CheckForConstructor(FileParsedData& fileData, ReflectContainerData& container, std::string_view view)
 	{
 		int i;
-		FileParsedData copy = fileData;
-		std::string line = GetFunctionLine(copy, i);
+		std::string_view line = GetFunctionLine(fileData, i);
 		if (line.find('~') != std::string::npos)
 		{
 			SkipFunctionBody(fileData);
@@ -586,7 +755,7 @@ namespace Reflect
 	bool FileParser::CheckForOperatorFunction(FileParsedData& fileData, std::string_view view)
 	{
 		int i;
-		std::string line = GetFunctionLine(fileData, i);
+		std::string_view line = GetFunctionLine(fileData, i);
 		size_t index = line.find(OperatorKey);
 		if (index != std::string::npos)
 		{
@@ -596,13 +765,11 @@ namespace Reflect
 		return false;
 	}
 
-	bool FileParser::CheckForComments(FileParsedData& fileData, std::string& line)
+	bool FileParser::CheckForComments(FileParsedData& fileData, std::string_view view)
 	{
-		// Remove all contents of a line with comments.
-		size_t index = line.find("//");
-		if (index != std::string::npos)
+		// Skip the rest of a line with a comment.
+		if (view.find("//") != std::string::npos)
 		{
-			line = line.substr(0, index);
 			FindNextChar(fileData, '\n');
 			return true;
 		}
@@ -645,19 +812,19 @@ namespace Reflect
 		}
 	}
 
-	ReflectFunctionData FileParser::GetFunction(FileParsedData& fileData, const std::vector<std::string>& flags)
+	ReflectFunctionData FileParser::GetFunction(FileParsedData& fileData, const ModelVector<InternedString>& flags)
 	{
-		ReflectFunctionData functionData;
+		ReflectFunctionData functionData(fileData.Arena.get());
 
 		int endOfLineCursor;
-		std::string line = GetFunctionLine(fileData, endOfLineCursor);
+		std::string line(GetFunctionLine(fileData, endOfLineCursor));
 
 		uint32_t cBracket = (uint32_t)line.find_last_of(')');
 		size_t functionConst = (uint32_t)line.find(ConstKey, cBracket);
 		if (functionConst != std::string::npos)
 		{
 			functionData.IsConst = true;
-			line = line.substr(0, cBracket + 1);
+			line.resize(cBracket + 1);
 		}
 		uint32_t oBracket = (uint32_t)line.find_first_of('(');
 		std::string prameters = line.substr(oBracket, cBracket);
@@ -670,15 +837,17 @@ namespace Reflect
 		while (std::find(emptyChars.begin(), emptyChars.end(), line.at(cursor)) != emptyChars.end())
 			--cursor;
 
+		std::string name;
 		while (std::find(emptyChars.begin(), emptyChars.end(), line.at(cursor)) == emptyChars.end())
 		{
-			functionData.Name += line.at(cursor);
+			name += line.at(cursor);
 			--cursor;
 		}
 		// We should now have just the type.
 		// TODO: Think about how to handle 'inline' modifiers and suck.
 		// TODO: template support?
-		GetReflectNameAndReflectValueTypeAndReflectModifer(line, functionData.Name, functionData.ReflectValueType, functionData.ReflectModifier);
+		GetReflectNameAndReflectValueTypeAndReflectModifer(line, name, functionData.ReflectValueType, functionData.ReflectModifier);
+		functionData.Name = name;
 
 		// Make sure there are no empty chars in the type string.
 		for (const char& c : emptyChars)
@@ -689,21 +858,19 @@ namespace Reflect
 		return functionData;
 	}
 
-	ReflectMemberData FileParser::GetMember(FileParsedData& fileData, const std::vector<std::string>& flags)
+	ReflectMemberData FileParser::GetMember(FileParsedData& fileData, const ModelVector<InternedString>& flags)
 	{
-		ReflectMemberData memberData;
+		ReflectMemberData memberData(fileData.Arena.get());
 		memberData.TypeSize = DEFAULT_TYPE_SIZE;
 		memberData.ContainerProps = flags;
 
-		FileParsedData copy = fileData;
-		FindNextChar(copy, ';');
-		std::string line = fileData.Data.substr(fileData.Cursor, copy.Cursor - fileData.Cursor);
+		const int endOfMemberCursor = FindNextCharCursor(fileData, fileData.Cursor, ';');
+		std::string line = fileData.Data.substr(fileData.Cursor, endOfMemberCursor - fileData.Cursor);
 		int endOfLineCursor = fileData.Cursor + (int)line.size();
-		line += ';';
 
-		// Check for if there is a deault value being set.
+		// Check for if there is a deault value being set. The line stops at the ';'.
 		uint32_t equalCursor = (uint32_t)line.find('=');
-		uint32_t semicolonCursor = (uint32_t)line.find(';');
+		uint32_t semicolonCursor = (uint32_t)line.size();
 		uint32_t cursor = equalCursor < semicolonCursor ? equalCursor : semicolonCursor;
 
 		// Always go back one so we are not on '=' or ';';
@@ -711,28 +878,27 @@ namespace Reflect
 		// Go back untill we are not on an empty char.
 		while (std::find(emptyChars.begin(), emptyChars.end(), line.at(cursor)) != emptyChars.end())
 			--cursor;
-		line = line.substr(0, cursor + 1);
+		line.resize(cursor + 1);
 
 		// 'line' should now contain the value, member name and any modifers like const.
-		std::vector<char> endChars = emptyChars;
-		endChars.push_back('*');
-		endChars.push_back('&');
-		while (std::find(endChars.begin(), endChars.end(), line.at(cursor)) == endChars.end())
+		std::string name;
+		while (std::find(memberNameEndChars.begin(), memberNameEndChars.end(), line.at(cursor)) == memberNameEndChars.end())
 		{
-			memberData.Name += line.at(cursor);
+			name += line.at(cursor);
 			--cursor;
 		}
-		GetReflectNameAndReflectValueTypeAndReflectModifer(line, memberData.Name, memberData.ReflectValueType, memberData.ReflectModifier);
+		GetReflectNameAndReflectValueTypeAndReflectModifer(line, name, memberData.ReflectValueType, memberData.ReflectModifier);
+		memberData.Name = name;
 
 		cursor = (uint32_t)line.size() - 1;
 		while (std::find(emptyChars.begin(), emptyChars.end(), line.at(cursor)) != emptyChars.end())
 			--cursor;
-		std::string type = line.substr(0, cursor + 1);
+		line.resize(cursor + 1);
 
 		// Make sure there are no empty chars in the type string.
 		for (const char& c : emptyChars)
-			Util::RemoveCharAll(type, c);
-		memberData.Type = type;
+			Util::RemoveCharAll(line, c);
+		memberData.Type = line;
 
 		fileData.Cursor = endOfLineCursor;
 		return memberData;
@@ -740,46 +906,45 @@ namespace Reflect
 
 	void FileParser::SkipFunctionBody(FileParsedData& fileData)
 	{
-		FileParsedData bracketCursor = fileData;
-		FindNextChar(bracketCursor, '{');
-		FileParsedData semicolonCursor = fileData;
-		FindNextChar(semicolonCursor, ';');
+		fileData.Cursor = SkipFunctionBody(fileData, fileData.Cursor);
+	}
 
-		if (semicolonCursor.Cursor < bracketCursor.Cursor)
+	int FileParser::SkipFunctionBody(const FileParsedData& fileData, int cursor)
+	{
+		const int bracketCursor = FindNextCharCursor(fileData, cursor, '{');
+		const int semicolonCursor = FindNextCharCursor(fileData, cursor, ';');
+		if (semicolonCursor < bracketCursor)
 		{
-			fileData.Cursor = semicolonCursor.Cursor;
-			return;
+			return semicolonCursor;
 		}
-		fileData.Cursor = bracketCursor.Cursor;
+		cursor = bracketCursor;
 
-		std::stack<char> brackets;
-		char c = fileData.Data[fileData.Cursor];
+		int depth = 0;
+		char c = fileData.Data[cursor];
 		while (true)
 		{
 			if (c == '{')
-				brackets.push('{');
+				++depth;
 			else if (c == '}')
-				brackets.pop();
+				--depth;
 
-			if (brackets.size() == 0)
+			if (depth == 0)
 			{
 				break;
 			}
-			c = fileData.Data[++fileData.Cursor];
+			c = fileData.Data[++cursor];
 		}
+		return cursor;
 	}
 
 	EReflectType FileParser::CheckForReflectType(FileParsedData& data)
 	{
-		auto find_closest_char = [data, this](std::vector<char> const& chars_to_find)
+		auto find_closest_char = [&data, this](std::vector<char> const& chars_to_find)
 		{
 			int cursor = INT_MAX;
-			for (size_t i = 0; i < chars_to_find.size(); ++i)
+			for (char charToFind : chars_to_find)
 			{
-				char charToFind = chars_to_find.at(i);
-				FileParsedData copy = data;
-				FindNextChar(copy, charToFind);
-				cursor = std::min(copy.Cursor, cursor);
+				cursor = std::min(FindNextCharCursor(data, data.Cursor, charToFind), cursor);
 			}
 			return cursor;
 		};
@@ -787,7 +952,8 @@ namespace Reflect
 		int member_cursor = find_closest_char(memberStartChars);
 		int function_cursor = find_closest_char(functionStartChars);
 
-		bool isTemplate = data.Data.find(TemplateKey, data.Cursor) < member_cursor;
+		// Only look up to the member, searching the rest of the file for every member is quadratic.
+		bool isTemplate = std::string_view(data.Data).substr(data.Cursor, member_cursor - data.Cursor).find(TemplateKey) != std::string::npos;
 
 		if (member_cursor < function_cursor && !isTemplate)
 		{
@@ -812,14 +978,14 @@ namespace Reflect
 			return true;
 		}
 
-		FileParsedData copy = fileData;
-		char c = copy.Data[copy.Cursor];
+		int nextCursor = fileData.Cursor;
+		char c = fileData.Data[nextCursor];
 		bool endOfFile = false;
 		char previousValidChar = c;
-		while (copy.Cursor < cursor)
+		while (nextCursor < cursor)
 		{
-			++copy.Cursor;
-			c = copy.Data[copy.Cursor];
+			++nextCursor;
+			c = fileData.Data[nextCursor];
 			if (std::find(emptyChars.begin(), emptyChars.end(), c) == emptyChars.end())
 			{
 				if (previousValidChar == '}')
@@ -830,8 +996,8 @@ namespace Reflect
 			}
 		}
 		if (endOfFile)
-			fileData.Cursor = ++copy.Cursor;
-		return endOfFile || copy.Cursor == cursor;
+			fileData.Cursor = ++nextCursor;
+		return endOfFile || nextCursor == cursor;
 	}
 
 	EReflectValueType FileParser::CheckForRefOrPtr(std::string_view view)
@@ -874,32 +1040,28 @@ namespace Reflect
 		return EReflectValueModifier::None;
 	}
 
-	std::string FileParser::GetFunctionLine(const FileParsedData& fileData, int& endCursor)
+	std::string_view FileParser::GetFunctionLine(const FileParsedData& fileData, int& endCursor)
 	{
-		FileParsedData copy = fileData;
-		FindNextChar(copy, ';');
-		endCursor = copy.Cursor;
-		copy = fileData;
-		FindNextChar(copy, '{');
-		if (copy.Cursor < endCursor)
+		endCursor = FindNextCharCursor(fileData, fileData.Cursor, ';');
+		const int bracketCursor = FindNextCharCursor(fileData, fileData.Cursor, '{');
+		if (bracketCursor < endCursor)
 		{
-			SkipFunctionBody(copy);
-			endCursor = copy.Cursor;
+			endCursor = SkipFunctionBody(fileData, bracketCursor);
 		}
 		else
 		{
-			endCursor = std::min(copy.Cursor, endCursor);
+			endCursor = std::min(bracketCursor, endCursor);
 		}
-		return fileData.Data.substr(fileData.Cursor, endCursor - fileData.Cursor);
+		return std::string_view(fileData.Data).substr(fileData.Cursor, endCursor - fileData.Cursor);
 	}
 
-	std::vector<ReflectTypeNameData> FileParser::ReflectGetFunctionParameters(const FileParsedData& fileData, std::string_view view)
+	ModelVector<ReflectTypeNameData> FileParser::ReflectGetFunctionParameters(const FileParsedData& fileData, std::string_view view)
 	{
 		int cursor = 0;
 		if (view.at(0) == '(')
 			++cursor;
 
-		std::vector<ReflectTypeNameData> parameters;
+		ModelVector<ReflectTypeNameData> parameters(fileData.Arena.get());
 		std::string str;
 		char c = view.at(cursor);
 		while (cursor < view.size())
@@ -910,7 +1072,7 @@ namespace Reflect
 			{
 				if (str.size() > 0 && !Util::StringContains(str, emptyChars))
 				{
-					ReflectTypeNameData parameter;
+					ReflectTypeNameData parameter(fileData.Arena.get());
 
 					std::size_t defaultValueIndex = str.find('=');
 					if (defaultValueIndex != std::string::npos)
@@ -923,26 +1085,30 @@ namespace Reflect
 					while (std::find(emptyChars.begin(), emptyChars.end(), view.at(copyCursor)) != emptyChars.end())
 						--copyCursor;
 
+					std::string name;
 					while (std::find(emptyChars.begin(), emptyChars.end(), view.at(copyCursor)) == emptyChars.end())
 					{
-						parameter.Name += view.at(copyCursor);
+						name += view.at(copyCursor);
 						--copyCursor;
 						CheckStringViewBounds(fileData, copyCursor, view);
 					}
-					GetReflectNameAndReflectValueTypeAndReflectModifer(str, parameter.Name, parameter.ReflectValueType, parameter.ReflectModifier);
+					GetReflectNameAndReflectValueTypeAndReflectModifer(str, name, parameter.ReflectValueType, parameter.ReflectModifier);
+					parameter.Name = name;
 
+					std::string type;
 					while (view.at(copyCursor) != '(' && view.at(copyCursor) != ',')
 					{
-						parameter.Type += view.at(copyCursor);
+						type += view.at(copyCursor);
 						--copyCursor;
 						CheckStringViewBounds(fileData, copyCursor, view);
 					}
-					parameter.Type = Util::Reverse(parameter.Type);
-					Util::RemoveCharReverse(parameter.Type, ReferenceKey);
-					Util::RemoveCharReverse(parameter.Type, PointerKey);
+					type = Util::Reverse(type);
+					Util::RemoveCharReverse(type, ReferenceKey);
+					Util::RemoveCharReverse(type, PointerKey);
+					parameter.Type = type;
 
 					str = {};
-					parameters.push_back(parameter);
+					parameters.push_back(std::move(parameter));
 				}
 				if (c == ')')
 				{
@@ -975,17 +1141,12 @@ namespace Reflect
 
 	int FileParser::CountNumberOfSinceTop(const FileParsedData& fileData, int cursorStart, const char& character)
 	{
-		int count = 0;
-		while (cursorStart > 0)
+		if (cursorStart <= 0)
 		{
-			//TODO Out of bounds checks.
-			if (fileData.Data[cursorStart] == character)
-			{
-				++count;
-			}
-			--cursorStart;
+			return 0;
 		}
-		return count;
+		// Everything after the first character, up to and including 'cursorStart'.
+		return static_cast<int>(std::count(fileData.Data.begin() + 1, fileData.Data.begin() + std::min<size_t>(cursorStart + 1, fileData.Data.size()), character));
 	}
 
 	std::string FileParser::PrettyString(std::string str)
@@ -0,0 +1,180 @@
+#include "FileParser/HeaderCache.h"
+#include "FileParser/FileParser.h"
+#include "Core/Log.h"
+#include "Instrumentor.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+
+namespace Reflect
+{
+	namespace
+	{
+		/// <summary>
+		/// The paths in the #include "..." lines of 'text'. Lines which are commented out with // are skipped.
+		/// </summary>
+		std::vector<std::string> FindQuotedIncludes(const std::string& text)
+		{
+			std::vector<std::string> includes;
+			size_t cursor = 0;
+			while ((cursor = text.find('#', cursor)) != std::string::npos)
+			{
+				// Only a '#' with nothing but whitespace in front of it on its line is a directive.
+				const size_t lineEnd = text.find_last_of('\n', cursor);
+				const size_t lineStart = lineEnd == std::string::npos ? 0 : lineEnd + 1;
+				const bool directive = text.find_first_not_of(" \t", lineStart) == cursor;
+				++cursor;
+				if (!directive)
+				{
+					continue;
+				}
+
+				cursor = text.find_first_not_of(" \t", cursor);
+				if (cursor == std::string::npos || text.compare(cursor, 7, "include") != 0)
+				{
+					continue;
+				}
+				cursor = text.find_first_not_of(" \t", cursor + 7);
+				if (cursor == std::string::npos || text[cursor] != '"')
+				{
+					continue;
+				}
+				const size_t end = text.find_first_of("\"\n", cursor + 1);
+				if (end == std::string::npos || text[end] != '"')
+				{
+					continue;
+				}
+				includes.push_back(text.substr(cursor + 1, end - cursor - 1));
+				cursor = end + 1;
+			}
+			return includes;
+		}
+	}
+
+	HeaderCache::HeaderCache(FileParser& parser)
+		: m_parser(parser)
+	{ }
+
+	HeaderCache::~HeaderCache()
+	{ }
+
+	FileParsedData* HeaderCache::Parse(const std::string& headerPath)
+	{
+		const std::string path = NormalisePath(headerPath);
+		Entry& entry = GetEntry(path);
+		std::call_once(entry.ParseOnce, [this, &entry, &path]()
+		{
+			std::error_code err;
+			if (!std::filesystem::is_regular_file(path, err))
+			{
+				Log_Error("[HeaderCache::Parse] '%s' is not a file.", path.c_str());
+				return;
+			}
+
+			entry.Reflected = m_parser.ParseFile(path, entry.Data);
+			// The text is here anyway, so the includes don't need reading again.
+			ReadIncludes(entry, path, &entry.Data.Data);
+			if (entry.Reflected)
+			{
+				// Only the parsed model is needed from here, don't hold on to the text of every header.
+				std::string().swap(entry.Data.Data);
+			}
+			else
+			{
+				entry.Data = FileParsedData();
+			}
+		});
+		return entry.Reflected ? &entry.Data : nullptr;
+	}
+
+	std::vector<std::string> HeaderCache::GetIncludedHeaders(const std::string& headerPath)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		const std::string path = NormalisePath(headerPath);
+		std::vector<std::string> headers;
+		std::unordered_set<std::string> seen = { path };
+		std::vector<std::string> toVisit = { path };
+		while (!toVisit.empty())
+		{
+			const std::string current = std::move(toVisit.back());
+			toVisit.pop_back();
+
+			Entry& entry = GetEntry(current);
+			ReadIncludes(entry, current, nullptr);
+			for (const std::string& include : entry.Includes)
+			{
+				if (seen.insert(include).second)
+				{
+					headers.push_back(include);
+					toVisit.push_back(include);
+				}
+			}
+		}
+		std::sort(headers.begin(), headers.end());
+		return headers;
+	}
+
+	bool HeaderCache::Take(const std::string& headerPath, FileParsedData& data)
+	{
+		std::lock_guard lock(m_mutex);
+		auto itr = m_entries.find(NormalisePath(headerPath));
+		if (itr == m_entries.end() || !itr->second->Reflected)
+		{
+			return false;
+		}
+		data = std::move(itr->second->Data);
+		itr->second->Reflected = false;
+		return true;
+	}
+
+	std::string HeaderCache::NormalisePath(const std::string& headerPath)
+	{
+		return std::filesystem::path(headerPath).lexically_normal().generic_u8string();
+	}
+
+	HeaderCache::Entry& HeaderCache::GetEntry(const std::string& normalisedPath)
+	{
+		std::lock_guard lock(m_mutex);
+		std::unique_ptr<Entry>& entry = m_entries[normalisedPath];
+		if (!entry)
+		{
+			entry = std::make_unique<Entry>();
+		}
+		return *entry;
+	}
+
+	void HeaderCache::ReadIncludes(Entry& entry, const std::string& normalisedPath, const std::string* text)
+	{
+		std::call_once(entry.IncludesOnce, [&entry, &normalisedPath, text]()
+		{
+			std::string fileText;
+			if (text == nullptr)
+			{
+				std::ifstream file(normalisedPath, std::ios::binary);
+				if (!file.is_open())
+				{
+					return;
+				}
+				fileText.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			}
+
+			const std::filesystem::path directory = std::filesystem::path(normalisedPath).parent_path();
+			for (const std::string& include : FindQuotedIncludes(text != nullptr ? *text : fileText))
+			{
+				if (include.find(ReflectFileGeneratePrefix) != std::string::npos)
+				{
+					continue;
+				}
+				std::error_code err;
+				const std::filesystem::path includePath = directory / include;
+				if (std::filesystem::is_regular_file(includePath, err))
+				{
+					entry.Includes.push_back(includePath.lexically_normal().generic_u8string());
+				}
+			}
+		});
+	}
+}
@@ -0,0 +1,102 @@
+#include "FileParser/InheritanceResolver.h"
+#include "Instrumentor.h"
+#include <algorithm>
+
+namespace Reflect
+{
+	// Deeper than any real hierarchy, stops a class which (by mistake) inherits from itself.
+	constexpr size_t MaxInheritanceDepth = 64;
+
+	InheritanceResolver::InheritanceResolver(HeaderCache& headers)
+		: m_headers(headers)
+	{ }
+
+	void InheritanceResolver::Resolve(FileParsedData& data) const
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		const std::string headerPath = data.FilePath + "/" + data.FileName + data.FileExtension;
+		data.IncludedHeaders = m_headers.GetIncludedHeaders(headerPath);
+
+		ContainerMap containers;
+		auto addFile = [&containers](const FileParsedData& file)
+		{
+			for (const ReflectContainerData& container : file.ReflectData)
+			{
+				containers[container.Name].push_back({ &container, &file });
+			}
+		};
+		addFile(data);
+		for (const std::string& include : data.IncludedHeaders)
+		{
+			const FileParsedData* includeData = m_headers.Parse(include);
+			if (includeData != nullptr && includeData != &data)
+			{
+				addFile(*includeData);
+			}
+		}
+
+		for (ReflectContainerData& container : data.ReflectData)
+		{
+			container.ResolvedBases.clear();
+
+			std::vector<const ContainerEntry*> bases;
+			if (!CollectBases(containers, container, bases, 0))
+			{
+				Log_Verbose("[InheritanceResolver::Resolve] '%s' has a base which isn't reflected or isn't public, it uses the __super chain.", container.Name.c_str());
+				continue;
+			}
+
+			container.ResolvedBases.reserve(bases.size());
+			for (const ContainerEntry* base : bases)
+			{
+				const FileParsedData& baseFile = *base->File;
+				container.ResolvedBases.push_back({ base->Container->Name, baseFile.FilePath + "/" + baseFile.FileName + baseFile.FileExtension,
+					base->Container->Members, base->Container->Functions });
+			}
+		}
+	}
+
+	bool InheritanceResolver::CollectBases(const ContainerMap& containers, const ReflectContainerData& container, std::vector<const ContainerEntry*>& bases, size_t depth) const
+	{
+		if (depth > MaxInheritanceDepth)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < container.Inheritance.size(); ++i)
+		{
+			const InternedString baseName = container.Inheritance[i];
+			if (baseName.Get().find("REFLECT_BASE") != std::string::npos)
+			{
+				// IReflect, nothing to add.
+				continue;
+			}
+			if (i >= container.InheritanceAccess.size() || container.InheritanceAccess[i] != EReflectAccess::Public)
+			{
+				// The flattened tables convert to the base outside the class, which only compiles for public bases.
+				return false;
+			}
+
+			auto itr = containers.find(baseName);
+			if (itr == containers.end() || itr->second.size() != 1)
+			{
+				// Not reflected, or more than one container with the name (in different namespaces).
+				return false;
+			}
+
+			const ContainerEntry* base = &itr->second.front();
+			if (!CollectBases(containers, *base->Container, bases, depth + 1))
+			{
+				return false;
+			}
+			if (std::find(bases.begin(), bases.end(), base) != bases.end())
+			{
+				// In the hierarchy twice, the cast to it would be ambiguous.
+				return false;
+			}
+			bases.push_back(base);
+		}
+		return true;
+	}
+}
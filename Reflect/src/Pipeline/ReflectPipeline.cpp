@@ -0,0 +1,141 @@
+#include "Pipeline/ReflectPipeline.h"
+#include "FileParser/FileParser.h"
+#include "FileParser/HeaderCache.h"
+#include "FileParser/InheritanceResolver.h"
+#include "Database/ReflectDatabase.h"
+#include "Core/RunStats.h"
+#include "Core/ThreadPool.h"
+#include "Core/Log.h"
+#include "Instrumentor.h"
+#include <atomic>
+#include <filesystem>
+
+namespace Reflect
+{
+	ReflectPipeline::ReflectPipeline(FileParser& parser, const ReflectAddtionalOptions& addtionalOptions)
+		: m_parser(parser)
+		, m_options(addtionalOptions)
+	{
+		m_parser.SetOptions(m_options);
+	}
+
+	ReflectPipeline::~ReflectPipeline()
+	{ }
+
+	bool ReflectPipeline::Run(const std::vector<std::string>& headerPaths)
+	{
+		REFLECT_PROFILE_FUNCTION();
+
+		if (!CheckOptions(m_options))
+		{
+			return false;
+		}
+
+		const bool incremental = m_options.options.at(Reflect_CMD_Option_Incremental) == "true";
+
+		// The previous database gives the parsed data of the headers skipped by incremental, so the new one still has every header.
+		const std::string& databasePath = m_options.options.at(Reflect_CMD_Option_Database);
+		ReflectDatabaseWriter databaseWriter;
+		ReflectDatabase previousDatabase;
+		if (incremental && !databasePath.empty() && std::filesystem::exists(databasePath) && !previousDatabase.Open(databasePath))
+		{
+			Log_Warn("Previous database not used, every header is parsed again. %s", previousDatabase.GetError().c_str());
+		}
+
+		// Each header is parsed once, whether it is reflected in this run or only included by one which is.
+		HeaderCache headers(m_parser);
+		InheritanceResolver resolver(headers);
+
+		// Headers whose generated files are newer than them and the headers they include are skipped with
+		// incremental=true, so the build can run the tool on every change and only pay for the headers which changed.
+		std::vector<FileParsedData> skippedData(headerPaths.size());
+		std::vector<char> skipped(headerPaths.size(), 0);
+		std::atomic<size_t> skippedFileCount = 0;
+		auto reflectFile = [&](size_t index)
+		{
+			const std::string& filePath = headerPaths[index];
+			if (incremental && CodeGenerate::IsUpToDate(filePath, headers.GetIncludedHeaders(filePath), m_options))
+			{
+				const DatabaseFormat::File* previousFile = previousDatabase.IsOpen() ? previousDatabase.FindFile(filePath) : nullptr;
+				if (databasePath.empty() || previousFile != nullptr)
+				{
+					if (previousFile != nullptr)
+					{
+						previousDatabase.GetFileParsedData(*previousFile, skippedData[index]);
+					}
+					skipped[index] = 1;
+					++skippedFileCount;
+					return;
+				}
+			}
+
+			// The bases are in this header or the ones it includes, so it is generated as soon as it is parsed.
+			FileParsedData* data = headers.Parse(filePath);
+			if (data != nullptr)
+			{
+				resolver.Resolve(*data);
+				m_codeGenerate.Reflect(*data, m_options);
+			}
+		};
+
+		if (m_options.options.at(Reflect_CMD_Option_Parallel) == "true")
+		{
+			// Every file goes through parse -> resolve -> generate -> write on a worker, so one file can be
+			// written while others are still being parsed.
+			ThreadPool pool(ThreadPool::ThreadCountFromString(m_options.options.at(Reflect_CMD_Option_Threads)));
+			for (size_t i = 0; i < headerPaths.size(); ++i)
+			{
+				pool.Submit([&reflectFile, i]() { reflectFile(i); });
+			}
+			pool.Wait();
+		}
+		else
+		{
+			for (size_t i = 0; i < headerPaths.size(); ++i)
+			{
+				reflectFile(i);
+			}
+		}
+
+		m_skippedFileCount = skippedFileCount;
+		if (m_skippedFileCount > 0)
+		{
+			Log_Info("Skipped %zu up to date file(s).", m_skippedFileCount);
+		}
+		m_codeGenerate.WriteUnityFiles(m_options);
+		CodeGenerate::WriteDependencyManifest(headerPaths, m_options);
+
+		m_databaseWriteTime = 0;
+		if (!databasePath.empty())
+		{
+			const int64_t databaseStart = RunStats::Now();
+			for (size_t i = 0; i < headerPaths.size(); ++i)
+			{
+				FileParsedData data;
+				if (skipped[i])
+				{
+					databaseWriter.AddFile(std::move(skippedData[i]));
+				}
+				else if (headers.Take(headerPaths[i], data))
+				{
+					databaseWriter.AddFile(std::move(data));
+				}
+			}
+			// Closed first, the file can't be replaced while it is mapped on Windows.
+			previousDatabase.Close();
+			databaseWriter.Write(databasePath);
+			m_databaseWriteTime = RunStats::Now() - databaseStart;
+		}
+		return true;
+	}
+
+	bool ReflectPipeline::CheckOptions(const ReflectAddtionalOptions& addtionalOptions)
+	{
+		if (!addtionalOptions.options.at(Reflect_CMD_Option_File_List).empty() && CodeGenerate::GetUnityFileCount(addtionalOptions) > 0)
+		{
+			Log_Error("%s can't be used with %s, the unity files would only have the listed headers in them.", Reflect_CMD_Option_Unity_Files, Reflect_CMD_Option_File_List);
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,27 @@
+#include "ReflectStructs.h"
+
+namespace Reflect
+{
+	ReflectFunction IReflect::GetFunction(const char* functionName)
+	{
+		(void)functionName;
+		return ReflectFunction(nullptr, nullptr);
+	}
+
+	ReflectMember IReflect::GetMember(const char* memberName)
+	{
+		(void)memberName;
+		return ReflectMember("", nullptr, nullptr);
+	}
+
+	std::vector<ReflectMember> IReflect::GetMembers(std::vector<std::string> const& flags)
+	{
+		(void)flags;
+		return {};
+	}
+
+	std::vector<ReflectMember> IReflect::GetAllMembers()
+	{
+		return {};
+	}
+}
@@ -0,0 +1,163 @@
+#include "Benchmark.h"
+#include "Core/Core.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <ctime>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace Benchmark
+{
+	struct BenchmarkResult
+	{
+		std::string Name;
+		uint64_t Iterations;
+		double NanosecondsPerIteration;
+	};
+
+	std::vector<BenchmarkInfo>& GetBenchmarks()
+	{
+		static std::vector<BenchmarkInfo> benchmarks;
+		return benchmarks;
+	}
+
+	/// <summary>
+	/// Find how many iterations are needed for a run to take at least 'minTime' nanoseconds.
+	/// </summary>
+	uint64_t FindIterationCount(BenchmarkFunc func, int64_t minTime)
+	{
+		constexpr uint64_t MaxIterations = 1000000000;
+		uint64_t iterations = 1;
+		while (iterations < MaxIterations)
+		{
+			State state(iterations);
+			func(state);
+			int64_t elapsed = state.GetElapsedNanoseconds();
+			if (elapsed >= minTime)
+			{
+				break;
+			}
+
+			// Aim a bit past 'minTime', but don't grow by more than 10x as the first runs are noisy.
+			double multiplier = elapsed > 0 ? (minTime * 1.4) / elapsed : 10.0;
+			multiplier = std::clamp(multiplier, 2.0, 10.0);
+			iterations = std::min(MaxIterations, static_cast<uint64_t>(iterations * multiplier));
+		}
+		return iterations;
+	}
+
+	BenchmarkResult RunBenchmark(const BenchmarkInfo& benchmark, int64_t minTime, int repetitions)
+	{
+		uint64_t iterations = FindIterationCount(benchmark.Func, minTime);
+
+		std::vector<double> times;
+		for (int i = 0; i < repetitions; ++i)
+		{
+			State state(iterations);
+			benchmark.Func(state);
+			times.push_back(static_cast<double>(state.GetElapsedNanoseconds()) / iterations);
+		}
+		std::sort(times.begin(), times.end());
+		return { benchmark.Name, iterations, times[times.size() / 2] };
+	}
+
+	std::string ToJson(const std::vector<BenchmarkResult>& results)
+	{
+		char date[64] = { };
+		time_t now = time(nullptr);
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+		std::string json = "{\n  \"context\": {\n";
+		json += "    \"date\": \"" + std::string(date) + "\",\n";
+		json += "    \"reflect_version\": \"" + std::to_string(REFLECT_MAJOR) + "." + std::to_string(REFLECT_MINOR) + "." + std::to_string(REFLECT_PATCH) + "\",\n";
+#ifdef DEBUG
+		json += "    \"library_build_type\": \"debug\"\n";
+#else
+		json += "    \"library_build_type\": \"release\"\n";
+#endif
+		json += "  },\n  \"benchmarks\": [\n";
+
+		char buffer[512];
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const BenchmarkResult& result = results[i];
+			snprintf(buffer, sizeof(buffer),
+				"    {\"name\": \"%s\", \"run_name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %llu, \"real_time\": %.3f, \"cpu_time\": %.3f, \"time_unit\": \"ns\"}%s\n",
+				result.Name.c_str(), result.Name.c_str(), static_cast<unsigned long long>(result.Iterations),
+				result.NanosecondsPerIteration, result.NanosecondsPerIteration, i + 1 < results.size() ? "," : "");
+			json += buffer;
+		}
+		json += "  ]\n}\n";
+		return json;
+	}
+
+	int RunBenchmarks(int argc, char* argv[])
+	{
+		std::string filter;
+		std::string jsonPath;
+		double minTimeSeconds = 0.5;
+		int repetitions = 3;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			std::string argKey = arg.substr(0, arg.find('='));
+			std::string argValue = arg.find('=') != std::string::npos ? arg.substr(arg.find('=') + 1) : "";
+			if (argKey == "filter")
+			{
+				filter = argValue;
+			}
+			else if (argKey == "min_time")
+			{
+				minTimeSeconds = atof(argValue.c_str());
+			}
+			else if (argKey == "repetitions")
+			{
+				repetitions = std::max(1, atoi(argValue.c_str()));
+			}
+			else if (argKey == "json")
+			{
+				jsonPath = argValue;
+			}
+			else
+			{
+				std::cout << "Unknown argument '" << arg << "'.\n";
+				return 1;
+			}
+		}
+
+#ifdef DEBUG
+		std::cout << "***WARNING*** Benchmarks were built as DEBUG, timings will not be representative.\n";
+#endif
+		char buffer[256];
+		snprintf(buffer, sizeof(buffer), "%-48s %14s %14s\n", "Benchmark", "Time", "Iterations");
+		std::cout << buffer << std::string(78, '-') << '\n';
+
+		const int64_t minTime = static_cast<int64_t>(minTimeSeconds * 1e9);
+		std::vector<BenchmarkResult> results;
+		for (const BenchmarkInfo& benchmark : GetBenchmarks())
+		{
+			if (!filter.empty() && benchmark.Name.find(filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			BenchmarkResult result = RunBenchmark(benchmark, minTime, repetitions);
+			snprintf(buffer, sizeof(buffer), "%-48s %11.2f ns %14llu\n", result.Name.c_str(), result.NanosecondsPerIteration, static_cast<unsigned long long>(result.Iterations));
+			std::cout << buffer;
+			results.push_back(std::move(result));
+		}
+
+		if (!jsonPath.empty())
+		{
+			std::ofstream file(jsonPath, std::ios::trunc);
+			if (!file.is_open())
+			{
+				std::cout << "Could not write results to '" << jsonPath << "'.\n";
+				return 1;
+			}
+			file << ToJson(results);
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdint.h>
+
+/// <summary>
+/// Minimal micro benchmark harness, modelled on Google Benchmark so results can be compared the same way
+/// (the json output uses Google Benchmark's layout, so tools like compare.py can diff two runs).
+/// Example:
+///		void BM_Thing(Benchmark::State& state) { for (auto _ : state) { Benchmark::DoNotOptimize(Thing()); } }
+///		REFLECT_BENCHMARK(BM_Thing);
+/// </summary>
+namespace Benchmark
+{
+	class State
+	{
+	public:
+		struct Iterator
+		{
+			State* Parent;
+			uint64_t Remaining;
+
+			int operator*() const { return 0; }
+			Iterator& operator++()
+			{
+				--Remaining;
+				return *this;
+			}
+			bool operator!=(const Iterator&)
+			{
+				if (Remaining != 0)
+				{
+					return true;
+				}
+				Parent->StopTimer();
+				return false;
+			}
+		};
+
+		explicit State(uint64_t iterations)
+			: m_iterations(iterations)
+		{ }
+
+		Iterator begin()
+		{
+			StartTimer();
+			return Iterator{ this, m_iterations };
+		}
+		Iterator end() { return Iterator{ this, 0 }; }
+
+		/// <summary>
+		/// Exclude setup done inside the loop from the measured time.
+		/// </summary>
+		void PauseTiming() { StopTimer(); }
+		void ResumeTiming() { StartTimer(); }
+
+		uint64_t GetIterations() const { return m_iterations; }
+		int64_t GetElapsedNanoseconds() const { return m_elapsed; }
+
+	private:
+		void StartTimer() { m_start = std::chrono::steady_clock::now(); }
+		void StopTimer() { m_elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count(); }
+
+	private:
+		uint64_t m_iterations;
+		int64_t m_elapsed = 0;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	using BenchmarkFunc = void(*)(State& state);
+
+	struct BenchmarkInfo
+	{
+		std::string Name;
+		BenchmarkFunc Func;
+	};
+
+	std::vector<BenchmarkInfo>& GetBenchmarks();
+
+	struct Registrar
+	{
+		Registrar(const char* name, BenchmarkFunc func)
+		{
+			GetBenchmarks().push_back({ name, func });
+		}
+	};
+
+	/// <summary>
+	/// Stop the compiler from removing the computation of 'value'.
+	/// </summary>
+	template<typename T>
+	inline void DoNotOptimize(T const& value)
+	{
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	/// <summary>
+	/// Run all the registered benchmarks. Arguments are key=value pairs:
+	///		filter=<text>		Only run benchmarks with 'text' in their name.
+	///		min_time=<seconds>	Minimum time each repetition runs for. Defaults to 0.5.
+	///		repetitions=<count>	Number of repetitions, the median is reported. Defaults to 3.
+	///		json=<path>			Also write the results to 'path'.
+	/// </summary>
+	int RunBenchmarks(int argc, char* argv[]);
+}
+
+#define BENCHMARK_COMBINE_INNER(A, B) A##B
+#define BENCHMARK_COMBINE(A, B) BENCHMARK_COMBINE_INNER(A, B)
+
+#define REFLECT_BENCHMARK(func) static Benchmark::Registrar BENCHMARK_COMBINE(s_benchmarkRegistrar, __COUNTER__)(#func, func)
+#define REFLECT_BENCHMARK_TEMPLATE(func, type) static Benchmark::Registrar BENCHMARK_COMBINE(s_benchmarkRegistrar, __COUNTER__)(#func "<" #type ">", func<type>)
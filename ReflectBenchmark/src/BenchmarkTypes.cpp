@@ -0,0 +1,31 @@
+#include "BenchmarkTypes.h"
+
+void SmallType::Touch()
+{
+	++Value00;
+}
+
+int SmallType::Add(int const& value)
+{
+	return Value00 + value;
+}
+
+void MediumType::Touch()
+{
+	++Value00;
+}
+
+int MediumType::Add(int const& value)
+{
+	return Value00 + value;
+}
+
+void LargeType::Touch()
+{
+	++Value00;
+}
+
+int LargeType::Add(int const& value)
+{
+	return Value00 + value;
+}
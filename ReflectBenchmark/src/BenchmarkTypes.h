@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Reflect.h"
+#include "Generated/BenchmarkTypes_reflect_generated.h"
+
+/// <summary>
+/// 4 reflected members.
+/// </summary>
+REFLECT_STRUCT()
+struct SmallType : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	void Touch();
+	REFLECT_PROPERTY()
+	int Add(int const& value);
+
+	REFLECT_PROPERTY(Public)
+	int Value00 = 0;
+	REFLECT_PROPERTY()
+	float Value01 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value02;
+	REFLECT_PROPERTY()
+	double Value03 = 0.0;
+};
+
+/// <summary>
+/// 16 reflected members.
+/// </summary>
+REFLECT_STRUCT()
+struct MediumType : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	void Touch();
+	REFLECT_PROPERTY()
+	int Add(int const& value);
+
+	REFLECT_PROPERTY(Public)
+	int Value00 = 0;
+	REFLECT_PROPERTY()
+	float Value01 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value02;
+	REFLECT_PROPERTY()
+	double Value03 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value04 = 0;
+	REFLECT_PROPERTY()
+	float Value05 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value06;
+	REFLECT_PROPERTY()
+	double Value07 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value08 = 0;
+	REFLECT_PROPERTY()
+	float Value09 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value10;
+	REFLECT_PROPERTY()
+	double Value11 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value12 = 0;
+	REFLECT_PROPERTY()
+	float Value13 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value14;
+	REFLECT_PROPERTY()
+	double Value15 = 0.0;
+};
+
+/// <summary>
+/// 64 reflected members, lookups by name have to walk the whole table.
+/// </summary>
+REFLECT_STRUCT()
+struct LargeType : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	void Touch();
+	REFLECT_PROPERTY()
+	int Add(int const& value);
+
+	REFLECT_PROPERTY(Public)
+	int Value00 = 0;
+	REFLECT_PROPERTY()
+	float Value01 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value02;
+	REFLECT_PROPERTY()
+	double Value03 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value04 = 0;
+	REFLECT_PROPERTY()
+	float Value05 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value06;
+	REFLECT_PROPERTY()
+	double Value07 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value08 = 0;
+	REFLECT_PROPERTY()
+	float Value09 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value10;
+	REFLECT_PROPERTY()
+	double Value11 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value12 = 0;
+	REFLECT_PROPERTY()
+	float Value13 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value14;
+	REFLECT_PROPERTY()
+	double Value15 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value16 = 0;
+	REFLECT_PROPERTY()
+	float Value17 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value18;
+	REFLECT_PROPERTY()
+	double Value19 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value20 = 0;
+	REFLECT_PROPERTY()
+	float Value21 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value22;
+	REFLECT_PROPERTY()
+	double Value23 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value24 = 0;
+	REFLECT_PROPERTY()
+	float Value25 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value26;
+	REFLECT_PROPERTY()
+	double Value27 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value28 = 0;
+	REFLECT_PROPERTY()
+	float Value29 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value30;
+	REFLECT_PROPERTY()
+	double Value31 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value32 = 0;
+	REFLECT_PROPERTY()
+	float Value33 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value34;
+	REFLECT_PROPERTY()
+	double Value35 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value36 = 0;
+	REFLECT_PROPERTY()
+	float Value37 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value38;
+	REFLECT_PROPERTY()
+	double Value39 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value40 = 0;
+	REFLECT_PROPERTY()
+	float Value41 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value42;
+	REFLECT_PROPERTY()
+	double Value43 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value44 = 0;
+	REFLECT_PROPERTY()
+	float Value45 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value46;
+	REFLECT_PROPERTY()
+	double Value47 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value48 = 0;
+	REFLECT_PROPERTY()
+	float Value49 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value50;
+	REFLECT_PROPERTY()
+	double Value51 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value52 = 0;
+	REFLECT_PROPERTY()
+	float Value53 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value54;
+	REFLECT_PROPERTY()
+	double Value55 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value56 = 0;
+	REFLECT_PROPERTY()
+	float Value57 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value58;
+	REFLECT_PROPERTY()
+	double Value59 = 0.0;
+	REFLECT_PROPERTY(Public)
+	int Value60 = 0;
+	REFLECT_PROPERTY()
+	float Value61 = 0.0f;
+	REFLECT_PROPERTY(Public)
+	std::string Value62;
+	REFLECT_PROPERTY()
+	double Value63 = 0.0;
+};
\ No newline at end of file
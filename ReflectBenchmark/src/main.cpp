@@ -0,0 +1,144 @@
+#include "Benchmark.h"
+#include "BenchmarkTypes.h"
+
+// Runtime reflection paths, each run over types with 4, 16 and 64 reflected members.
+// Lookups by name use the last member so the whole table is searched.
+
+template<typename T>
+const char* GetLastMemberName()
+{
+	return (T::StaticTypeInfo().GetMembers().end() - 1)->Name;
+}
+
+template<typename T>
+void BM_GetMember(Benchmark::State& state)
+{
+	T object;
+	Reflect::IReflect& reflect = object;
+	const std::string memberName = GetLastMemberName<T>();
+	for (auto _ : state)
+	{
+		Benchmark::DoNotOptimize(reflect.GetMember(memberName.c_str()));
+	}
+}
+
+template<typename T>
+void BM_GetMemberStatic(Benchmark::State& state)
+{
+	T object;
+	const std::string memberName = GetLastMemberName<T>();
+	for (auto _ : state)
+	{
+		Benchmark::DoNotOptimize(Reflect::ReflectStatic<T>::GetMember(object, memberName.c_str()));
+	}
+}
+
+template<typename T>
+void BM_GetMembersWithFlags(Benchmark::State& state)
+{
+	T object;
+	Reflect::IReflect& reflect = object;
+	const std::vector<std::string> flags = { "Public" };
+	for (auto _ : state)
+	{
+		Benchmark::DoNotOptimize(reflect.GetMembers(flags));
+	}
+}
+
+template<typename T>
+void BM_GetAllMembers(Benchmark::State& state)
+{
+	T object;
+	Reflect::IReflect& reflect = object;
+	for (auto _ : state)
+	{
+		Benchmark::DoNotOptimize(reflect.GetAllMembers());
+	}
+}
+
+template<typename T>
+void BM_InvokeNoArgs(Benchmark::State& state)
+{
+	T object;
+	Reflect::ReflectFunction touch = object.GetFunction("Touch");
+	for (auto _ : state)
+	{
+		Benchmark::DoNotOptimize(touch.Invoke());
+	}
+}
+
+template<typename T>
+void BM_InvokeWithArgs(Benchmark::State& state)
+{
+	T object;
+	Reflect::ReflectFunction add = object.GetFunction("Add");
+	int value = 8;
+	int result = 0;
+	for (auto _ : state)
+	{
+		Reflect::FunctionPtrArgs args;
+		args.AddArg(&value);
+		Benchmark::DoNotOptimize(add.Invoke(&result, args));
+	}
+	Benchmark::DoNotOptimize(result);
+}
+
+template<typename T>
+void BM_ConvertToType(Benchmark::State& state)
+{
+	T object;
+	Reflect::ReflectMember member = object.GetMember("Value00");
+	for (auto _ : state)
+	{
+		Benchmark::DoNotOptimize(member.ConvertToType<int>());
+	}
+}
+
+template<typename T>
+void BM_CopyInt(Benchmark::State& state)
+{
+	T object;
+	T other;
+	Reflect::ReflectMember member = object.GetMember("Value00");
+	void* dst = other.GetMember("Value00").GetRawPointer();
+	for (auto _ : state)
+	{
+		member.GetType()->Copy(member.GetRawPointer(), dst);
+		Benchmark::DoNotOptimize(other.Value00);
+	}
+}
+
+template<typename T>
+void BM_CopyString(Benchmark::State& state)
+{
+	T object;
+	T other;
+	object.Value02 = "A string which is too long for the small string optimisation";
+	Reflect::ReflectMember member = object.GetMember("Value02");
+	void* dst = other.GetMember("Value02").GetRawPointer();
+	for (auto _ : state)
+	{
+		member.GetType()->Copy(member.GetRawPointer(), dst);
+		Benchmark::DoNotOptimize(other.Value02);
+	}
+}
+
+#define REFLECT_BENCHMARK_ALL_TYPES(func) \
+	REFLECT_BENCHMARK_TEMPLATE(func, SmallType); \
+	REFLECT_BENCHMARK_TEMPLATE(func, MediumType); \
+	REFLECT_BENCHMARK_TEMPLATE(func, LargeType)
+
+REFLECT_BENCHMARK_ALL_TYPES(BM_GetMember);
+REFLECT_BENCHMARK_ALL_TYPES(BM_GetMemberStatic);
+REFLECT_BENCHMARK_ALL_TYPES(BM_GetMembersWithFlags);
+REFLECT_BENCHMARK_ALL_TYPES(BM_GetAllMembers);
+REFLECT_BENCHMARK_ALL_TYPES(BM_InvokeNoArgs);
+REFLECT_BENCHMARK_ALL_TYPES(BM_InvokeWithArgs);
+REFLECT_BENCHMARK_ALL_TYPES(BM_ConvertToType);
+REFLECT_BENCHMARK_ALL_TYPES(BM_CopyInt);
+REFLECT_BENCHMARK_ALL_TYPES(BM_CopyString);
+
+int main(int argc, char* argv[])
+{
+	return Benchmark::RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,215 @@
+#include "CorpusGenerator.h"
+#include "Core/Core.h"
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <fstream>
+#include <vector>
+#include <stdio.h>
+
+namespace Corpus
+{
+	constexpr const char* CorpusFilePrefix = "Corpus_";
+
+	struct MemberType
+	{
+		const char* Type;
+		const char* Initialiser;
+	};
+
+	constexpr MemberType MemberTypes[] =
+	{
+		{ "int", " = 0" },
+		{ "float", " = 0.0f" },
+		{ "double", " = 0.0" },
+		{ "bool", " = false" },
+		{ "std::string", "" },
+		{ "std::vector<int>", "" },
+		{ "int*", " = nullptr" },
+	};
+
+	constexpr const char* Flags[] =
+	{
+		"",
+		"Public",
+		"EditorOnly",
+		"Public, EditorOnly",
+	};
+
+	constexpr const char* Comments[] =
+	{
+		"Cached value, updated once per frame.",
+		"Owned by the parent, don't delete.",
+		"TODO: Move this into the settings struct once the serializer supports nested types.",
+		"Number of items which are currently active. This is always less than or equal to the capacity.",
+	};
+
+	CorpusGenerator::CorpusGenerator(const CorpusOptions& options)
+		: m_options(options)
+		, m_random(options.Seed)
+	{ }
+
+	bool CorpusGenerator::Generate(const std::string& directory, CorpusInfo& info)
+	{
+		std::error_code err;
+		std::filesystem::create_directories(directory, err);
+
+		std::vector<std::filesystem::path> oldFiles;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, err))
+		{
+			if (entry.is_regular_file() && entry.path().filename().u8string().rfind(CorpusFilePrefix, 0) == 0)
+			{
+				oldFiles.push_back(entry.path());
+			}
+		}
+		for (const auto& path : oldFiles)
+		{
+			std::filesystem::remove(path, err);
+		}
+
+		info = { };
+		for (int i = 0; i < m_options.FileCount; ++i)
+		{
+			char subDirectory[32];
+			snprintf(subDirectory, sizeof(subDirectory), "Group_%d", i / std::max(1, m_options.FilesPerDirectory));
+			std::filesystem::path dirPath = std::filesystem::path(directory) / subDirectory;
+			std::filesystem::create_directories(dirPath, err);
+
+			std::string data = GenerateFile(i, info);
+			std::ofstream file(dirPath / (CorpusFilePrefix + std::to_string(i) + ".h"), std::ios::trunc | std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			file << data;
+			info.Bytes += data.size();
+			++info.FileCount;
+		}
+		return true;
+	}
+
+	std::string CorpusGenerator::GenerateFile(int fileIndex, CorpusInfo& info)
+	{
+		std::string file;
+		file += "#pragma once\n\n";
+		file += "#include \"ReflectFwd.h\"\n";
+		file += "#include \"Generated/" + (CorpusFilePrefix + std::to_string(fileIndex)) + Reflect::ReflectFileGeneratePrefix + ".h\"\n";
+		file += "#include <string>\n#include <vector>\n\n";
+
+		for (int i = 0; i < m_options.ContainersPerFile; ++i)
+		{
+			AppendContainer(file, fileIndex, i, i > 0 && Chance(m_options.InheritancePercent));
+			++info.ContainerCount;
+		}
+		return file;
+	}
+
+	void CorpusGenerator::AppendContainer(std::string& file, int fileIndex, int containerIndex, bool inherit)
+	{
+		const bool isClass = (containerIndex % 2) == 0;
+		const std::string name = CorpusFilePrefix + std::to_string(fileIndex) + "_" + std::to_string(containerIndex);
+
+		if (Chance(m_options.CommentPercent))
+		{
+			AppendComment(file, "");
+		}
+		file += isClass ? Reflect::RefectClassKey : Reflect::RefectStructKey;
+		file += "(";
+		AppendFlags(file);
+		file += ")\n";
+		file += isClass ? "class " : "struct ";
+		file += name + " : ";
+		if (inherit)
+		{
+			file += std::string("public ") + CorpusFilePrefix + std::to_string(fileIndex) + "_" + std::to_string(containerIndex - 1);
+		}
+		else
+		{
+			file += "REFLECT_BASE()";
+		}
+		file += "\n{\n\tREFLECT_GENERATED_BODY()\n\n";
+		if (isClass)
+		{
+			file += "public:\n";
+		}
+
+		// Something which isn't reflected, like most real code has.
+		file += "\tint Helper" + std::to_string(containerIndex) + "() const { return " + std::to_string(Range(0, 100)) + "; }\n\n";
+
+		for (int i = 0; i < m_options.FunctionsPerContainer; ++i)
+		{
+			AppendFunction(file, i);
+		}
+		if (m_options.FunctionsPerContainer > 0)
+		{
+			file += "\n";
+		}
+		for (int i = 0; i < m_options.MembersPerContainer; ++i)
+		{
+			AppendMember(file, i);
+		}
+		file += "};\n\n";
+	}
+
+	void CorpusGenerator::AppendMember(std::string& file, int memberIndex)
+	{
+		if (Chance(m_options.CommentPercent))
+		{
+			AppendComment(file, "\t");
+		}
+		const MemberType& type = MemberTypes[Range(0, static_cast<int>(std::size(MemberTypes)) - 1)];
+		file += "\tREFLECT_PROPERTY(";
+		AppendFlags(file);
+		file += ")\n\t";
+		file += type.Type;
+		file += " Value" + std::to_string(memberIndex) + type.Initialiser + ";\n";
+	}
+
+	void CorpusGenerator::AppendFunction(std::string& file, int functionIndex)
+	{
+		if (Chance(m_options.CommentPercent))
+		{
+			AppendComment(file, "\t");
+		}
+		file += "\tREFLECT_PROPERTY(";
+		AppendFlags(file);
+		file += ")\n\t";
+
+		const std::string name = "Function" + std::to_string(functionIndex);
+		switch (Range(0, 2))
+		{
+		case 0: file += "void " + name + "();\n"; break;
+		case 1: file += "int " + name + "(int const& value) const;\n"; break;
+		case 2: file += "std::string " + name + "(std::string const& name, int count);\n"; break;
+		}
+	}
+
+	void CorpusGenerator::AppendComment(std::string& file, const char* indent)
+	{
+		const char* comment = Comments[Range(0, static_cast<int>(std::size(Comments)) - 1)];
+		if (Chance(50))
+		{
+			file += indent + std::string("// ") + comment + "\n";
+		}
+		else
+		{
+			file += indent + std::string("/// <summary>\n") + indent + "/// " + comment + "\n" + indent + "/// </summary>\n";
+		}
+	}
+
+	void CorpusGenerator::AppendFlags(std::string& file)
+	{
+		file += Flags[Range(0, static_cast<int>(std::size(Flags)) - 1)];
+	}
+
+	bool CorpusGenerator::Chance(int percent)
+	{
+		return Range(0, 99) < percent;
+	}
+
+	int CorpusGenerator::Range(int min, int max)
+	{
+		// mt19937 is the same everywhere, unlike the std distributions, so the corpus doesn't change between compilers.
+		return min + static_cast<int>(m_random() % static_cast<uint32_t>(max - min + 1));
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <random>
+#include <stdint.h>
+
+namespace Corpus
+{
+	struct CorpusOptions
+	{
+		int FileCount = 200;
+		// Files are split over sub directories of this many files to exercise the recursive directory walk.
+		int FilesPerDirectory = 25;
+		int ContainersPerFile = 4;
+		int MembersPerContainer = 12;
+		int FunctionsPerContainer = 4;
+		// Percentage of containers which inherit from the previous container in the same file.
+		int InheritancePercent = 30;
+		// Percentage of members/functions which have a comment in front of them.
+		int CommentPercent = 25;
+		uint32_t Seed = 1;
+	};
+
+	struct CorpusInfo
+	{
+		size_t FileCount = 0;
+		size_t ContainerCount = 0;
+		size_t Bytes = 0;
+	};
+
+	/// <summary>
+	/// Write a procedurally generated set of reflected headers, shaped like a real code base, for
+	/// benchmarking the parser and code generator. The same options and seed always give the same corpus.
+	/// </summary>
+	class CorpusGenerator
+	{
+	public:
+		explicit CorpusGenerator(const CorpusOptions& options);
+
+		/// <summary>
+		/// Generate the corpus into 'directory'. Headers and generated code from a previous corpus are removed
+		/// first, anything else in 'directory' is left alone. Returns false if a file could not be written.
+		/// </summary>
+		bool Generate(const std::string& directory, CorpusInfo& info);
+
+	private:
+		std::string GenerateFile(int fileIndex, CorpusInfo& info);
+		void AppendContainer(std::string& file, int fileIndex, int containerIndex, bool inherit);
+		void AppendMember(std::string& file, int memberIndex);
+		void AppendFunction(std::string& file, int functionIndex);
+		void AppendComment(std::string& file, const char* indent);
+		void AppendFlags(std::string& file);
+
+		bool Chance(int percent);
+		int Range(int min, int max);
+
+	private:
+		CorpusOptions m_options;
+		std::mt19937 m_random;
+	};
+}
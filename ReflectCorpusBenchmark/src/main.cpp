@@ -0,0 +1,185 @@
+#include "Reflect.h"
+#include "CorpusGenerator.h"
+#include <filesystem>
+#include <algorithm>
+#include <string.h>
+#include <stdlib.h>
+
+struct IterationResult
+{
+	int64_t TotalTime = 0;
+	int64_t ParseTime = 0;
+	int64_t GenerateTime = 0;
+	uint64_t Allocations = 0;
+	// Writing the parsed model to the database and loading all of it back (database option), not part of the total.
+	int64_t DatabaseWriteTime = 0;
+	int64_t DatabaseLoadTime = 0;
+};
+
+int64_t Median(std::vector<int64_t> values)
+{
+	std::sort(values.begin(), values.end());
+	return values[values.size() / 2];
+}
+
+void PrintTimeRow(const char* name, std::vector<int64_t> times, const Corpus::CorpusInfo& info)
+{
+	const int64_t minTime = *std::min_element(times.begin(), times.end());
+	const double seconds = std::max(static_cast<double>(minTime) / 1e9, 1e-9);
+	printf("  %-10s %10.2f ms %10.2f ms %10.1f files/sec %10.1f containers/sec %8.2f MB/sec\n", name,
+		minTime / 1e6, Median(times) / 1e6, info.FileCount / seconds, info.ContainerCount / seconds, info.Bytes / (1024.0 * 1024.0) / seconds);
+}
+
+/// <summary>
+/// Generate a corpus of reflected headers and time ReflectEXE's run (ReflectPipeline) over it. Arguments are key=value pairs:
+///		files, files_per_dir, containers, members, functions	Shape of the corpus.
+///		inheritance, comments									Percentage of containers which inherit, and of members/functions with a comment.
+///		seed													Seed for the corpus, the same seed always gives the same corpus.
+///		dir														Where to write the corpus. Defaults to ReflectCorpus in the temp directory.
+///		iterations												Number of times to run the pipeline. Defaults to 3.
+/// With database=<path> writing the reflection database and loading every file back from it are timed too.
+/// Any ReflectEXE option (reflect_full_ext, report_json, report_slowest, log_level, parallel, threads, ...) is passed through.
+/// </summary>
+int main(int argc, char* argv[])
+{
+	Corpus::CorpusOptions corpusOptions;
+	std::string directory = (std::filesystem::temp_directory_path() / "ReflectCorpus").u8string();
+	int iterations = 3;
+
+	Reflect::ReflectAddtionalOptions options = { };
+	options.options[Reflect::Reflect_CMD_Option_Log_Level] = "warn";
+	options.options[Reflect::Reflect_CMD_Option_Report_Slowest] = "5";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string argKey = arg.substr(0, arg.find('='));
+		std::string argValue = arg.find('=') != std::string::npos ? arg.substr(arg.find('=') + 1) : "";
+		int value = atoi(argValue.c_str());
+		if (argKey == "files") { corpusOptions.FileCount = value; }
+		else if (argKey == "files_per_dir") { corpusOptions.FilesPerDirectory = value; }
+		else if (argKey == "containers") { corpusOptions.ContainersPerFile = value; }
+		else if (argKey == "members") { corpusOptions.MembersPerContainer = value; }
+		else if (argKey == "functions") { corpusOptions.FunctionsPerContainer = value; }
+		else if (argKey == "inheritance") { corpusOptions.InheritancePercent = value; }
+		else if (argKey == "comments") { corpusOptions.CommentPercent = value; }
+		else if (argKey == "seed") { corpusOptions.Seed = static_cast<uint32_t>(strtoul(argValue.c_str(), nullptr, 10)); }
+		else if (argKey == "dir") { directory = argValue; }
+		else if (argKey == "iterations") { iterations = std::max(1, value); }
+		else if (options.options.find(argKey) != options.options.end()) { options.options[argKey] = argValue; }
+		else
+		{
+			printf("Unknown argument '%s'.\n", arg.c_str());
+			return 1;
+		}
+	}
+	Reflect::Log::SetLevel(Reflect::Log::LogLevelFromString(options.options[Reflect::Reflect_CMD_Option_Log_Level]));
+	const bool parallel = options.options[Reflect::Reflect_CMD_Option_Parallel] == "true";
+
+	Corpus::CorpusInfo info;
+	int64_t generateStart = Reflect::RunStats::Now();
+	if (!Corpus::CorpusGenerator(corpusOptions).Generate(directory, info))
+	{
+		printf("Could not write the corpus to '%s'.\n", directory.c_str());
+		Reflect::Log::Shutdown();
+		return 1;
+	}
+	printf("Corpus: %zu files, %zu containers, %.2f MB in '%s' (generated in %.2f ms)\n", info.FileCount, info.ContainerCount,
+		info.Bytes / (1024.0 * 1024.0), directory.c_str(), (Reflect::RunStats::Now() - generateStart) / 1e6);
+
+	std::vector<IterationResult> results;
+	for (int i = 0; i < iterations; ++i)
+	{
+		Reflect::RunStats::Get().Reset();
+		const uint64_t allocations = Reflect::AllocationCounter::Get();
+
+		// The same run as ReflectEXE. Each file is parsed and then generated, so the parse/generate split
+		// comes from the phase times (summed over the workers with parallel=true, so only the total is shown then).
+		int64_t start = Reflect::RunStats::Now();
+		Reflect::FileParser parser;
+		Reflect::ReflectPipeline pipeline(parser, options);
+		if (!pipeline.Run(parser.CollectFiles(directory)))
+		{
+			Reflect::Log::Shutdown();
+			return 1;
+		}
+
+		IterationResult result;
+		result.TotalTime = Reflect::RunStats::Now() - start - pipeline.GetDatabaseWriteTime();
+		result.ParseTime = Reflect::RunStats::Get().GetPhaseTime(Reflect::EReflectPhase::DirectoryWalk)
+			+ Reflect::RunStats::Get().GetPhaseTime(Reflect::EReflectPhase::Load) + Reflect::RunStats::Get().GetPhaseTime(Reflect::EReflectPhase::Parse);
+		result.GenerateTime = Reflect::RunStats::Get().GetPhaseTime(Reflect::EReflectPhase::CodeGenerate) + Reflect::RunStats::Get().GetPhaseTime(Reflect::EReflectPhase::Write);
+		// Allocations are counted per thread, so with parallel=true the workers' allocations aren't included.
+		result.Allocations = Reflect::AllocationCounter::Get() - allocations;
+		result.DatabaseWriteTime = pipeline.GetDatabaseWriteTime();
+		results.push_back(result);
+
+		const std::string& databasePath = options.options[Reflect::Reflect_CMD_Option_Database];
+		if (!databasePath.empty())
+		{
+			// Rebuild the whole parsed model, the same thing the parse gives.
+			start = Reflect::RunStats::Now();
+			Reflect::ReflectDatabase database;
+			if (database.Open(databasePath))
+			{
+				for (const Reflect::DatabaseFormat::File& file : database.GetFiles())
+				{
+					Reflect::FileParsedData data;
+					database.GetFileParsedData(file, data);
+				}
+			}
+			else
+			{
+				printf("%s\n", database.GetError().c_str());
+			}
+			results.back().DatabaseLoadTime = Reflect::RunStats::Now() - start;
+		}
+	}
+	Reflect::Log::Flush();
+
+	std::vector<int64_t> parseTimes, generateTimes, totalTimes, databaseWriteTimes, databaseLoadTimes;
+	for (const IterationResult& result : results)
+	{
+		parseTimes.push_back(result.ParseTime);
+		generateTimes.push_back(result.GenerateTime);
+		totalTimes.push_back(result.TotalTime);
+		databaseWriteTimes.push_back(result.DatabaseWriteTime);
+		databaseLoadTimes.push_back(result.DatabaseLoadTime);
+	}
+	printf("%d iterations %15s %13s\n", iterations, "min", "median");
+	if (!parallel)
+	{
+		PrintTimeRow("Parse", parseTimes, info);
+		PrintTimeRow("Generate", generateTimes, info);
+	}
+	PrintTimeRow("Total", totalTimes, info);
+	if (!options.options[Reflect::Reflect_CMD_Option_Database].empty())
+	{
+		PrintTimeRow("DB write", databaseWriteTimes, info);
+		PrintTimeRow("DB load", databaseLoadTimes, info);
+	}
+	if (Reflect::AllocationCounter::IsEnabled())
+	{
+		printf("  Allocations per iteration: %llu\n", static_cast<unsigned long long>(results.back().Allocations));
+	}
+	printf("  Interned strings: %zu (%zu bytes)\n\n", Reflect::StringInterner::Get().GetStringCount(), Reflect::StringInterner::Get().GetTotalBytes());
+
+	// Breakdown of the last iteration.
+	const size_t slowestCount = strtoul(options.options[Reflect::Reflect_CMD_Option_Report_Slowest].c_str(), nullptr, 10);
+	printf("%s", Reflect::RunStats::Get().ToString(results.back().TotalTime, slowestCount).c_str());
+
+	const std::string& reportJsonPath = options.options[Reflect::Reflect_CMD_Option_Report_Json];
+	if (!reportJsonPath.empty())
+	{
+		std::ofstream reportFile(reportJsonPath, std::ios::trunc);
+		if (!reportFile.is_open())
+		{
+			printf("Could not write report to '%s'.\n", reportJsonPath.c_str());
+			Reflect::Log::Shutdown();
+			return 1;
+		}
+		reportFile << Reflect::RunStats::Get().ToJson(results.back().TotalTime, slowestCount);
+	}
+	Reflect::Log::Shutdown();
+	return 0;
+}
@@ -1,18 +1,23 @@
 #include "Reflect.h"
+#include <algorithm>
 #include <filesystem>
 #include <string_view>
 #include <string.h>
+#include <stdlib.h>
+#include <unordered_set>
 
 int main(int argc, char* argv[])
 {
+	// The profiler's own buffers don't need to go through the tracking operator new.
+	REFLECT_PROFILE_SET_MEMORY_ALLOCATOR(malloc, free, nullptr);
+	REFLECT_PROFILE_THREAD("Main");
 	REFLECT_PROFILE_BEGIN_SESSION();
+	Reflect::ReflectAddtionalOptions options = { };
 	Reflect::Profile::InstrumentationTimer timer("Reflect Timer");
 	{
 		REFLECT_PROFILE_SCOPE("MAIN");
 
 		Reflect::FileParser parser;
-		Reflect::CodeGenerate codeGenerate;
-		Reflect::ReflectAddtionalOptions options = { };
 
 		std::vector<std::string> directories;
 		for (size_t i = 0; i < argc; ++i)
@@ -33,6 +38,10 @@ int main(int argc, char* argv[])
 			}
 		}
 
+		REFLECT_PROFILE_SET_CATEGORY_FILTER(options.options[Reflect::Reflect_CMD_Option_Profile_Categories]);
+		Reflect::Log::SetLevel(Reflect::Log::LogLevelFromString(options.options[Reflect::Reflect_CMD_Option_Log_Level]));
+		Reflect::Log::SetQuiet(options.options[Reflect::Reflect_CMD_Option_Quiet] == "true");
+
 		std::ifstream iFile(Reflect::ReflectIgnoreStringsFileName);
 		if (iFile.is_open())
 		{
@@ -47,20 +56,97 @@ int main(int argc, char* argv[])
 			parser.SetIgnoreStrings(Reflect::Util::SplitString(data.data(), '\n'));
 		}
 
+		const size_t shardCount = strtoul(options.options[Reflect::Reflect_CMD_Option_Shard_Count].c_str(), nullptr, 10);
+		const size_t shardIndex = strtoul(options.options[Reflect::Reflect_CMD_Option_Shard_Index].c_str(), nullptr, 10);
+		if (shardCount == 0 || shardIndex >= shardCount)
+		{
+			Log_Error("%s must be less than %s, and %s must be at least 1.", Reflect::Reflect_CMD_Option_Shard_Index, Reflect::Reflect_CMD_Option_Shard_Count, Reflect::Reflect_CMD_Option_Shard_Count);
+			Reflect::Log::Shutdown();
+			return 1;
+		}
+		if (!Reflect::ReflectPipeline::CheckOptions(options))
+		{
+			Reflect::Log::Shutdown();
+			return 1;
+		}
+		if (shardCount > 1 && Reflect::CodeGenerate::GetUnityFileCount(options) > 0)
+		{
+			// Each shard would write the same unity files with only its own headers in them.
+			Log_Warn("%s can't be used with %s, one .cpp is generated per header.", Reflect::Reflect_CMD_Option_Unity_Files, Reflect::Reflect_CMD_Option_Shard_Count);
+			options.options[Reflect::Reflect_CMD_Option_Unity_Files] = "0";
+		}
+
+		const bool incremental = options.options[Reflect::Reflect_CMD_Option_Incremental] == "true";
+		if (incremental && Reflect::CodeGenerate::GetUnityFileCount(options) > 0)
+		{
+			Log_Warn("%s=true has no effect with unity_files, every header is parsed so the unity files are complete.", Reflect::Reflect_CMD_Option_Incremental);
+		}
+
+		// Every header from the directories and the file list. A header gives the same generated
+		// files whichever way it was found.
+		std::vector<std::string> headerPaths;
+		parser.SetOptions(options);
 		for (auto& dir : directories)
 		{
-			parser.ParseDirectory(dir, options);
-			for (auto& file : parser.GetAllFileParsedData())
+			for (std::string& filePath : parser.CollectFiles(dir))
+			{
+				headerPaths.push_back(std::move(filePath));
+			}
+		}
+		const std::string& fileList = options.options[Reflect::Reflect_CMD_Option_File_List];
+		if (!fileList.empty())
+		{
+			for (std::string& filePath : parser.CollectFilesFromList(fileList))
 			{
-				codeGenerate.Reflect(file, options);
+				headerPaths.push_back(std::move(filePath));
 			}
 		}
+		{
+			// A header in both a directory and the list is only parsed once, two workers writing the same files would race.
+			std::unordered_set<std::string> seenPaths;
+			headerPaths.erase(std::remove_if(headerPaths.begin(), headerPaths.end(), [&seenPaths](const std::string& filePath)
+			{
+				return !seenPaths.insert(std::filesystem::path(filePath).lexically_normal().generic_u8string()).second;
+			}), headerPaths.end());
+		}
+		if (shardCount > 1)
+		{
+			headerPaths.erase(std::remove_if(headerPaths.begin(), headerPaths.end(), [shardIndex, shardCount](const std::string& filePath)
+			{
+				return !Reflect::FileParser::IsInShard(filePath, shardIndex, shardCount);
+			}), headerPaths.end());
+			Log_Info("Shard %zu of %zu: %zu file(s).", shardIndex, shardCount, headerPaths.size());
+		}
+
+		Reflect::ReflectPipeline pipeline(parser, options);
+		pipeline.Run(headerPaths);
 	}
 	timer.Stop();
-	std::cout << "Reflect micro: " << timer.GetElapsedTimeMicro() << std::endl;
-	std::cout << "Reflect mill: " << timer.GetElapsedTimeMill() << std::endl;
-	std::cout << "Reflect sec: " << timer.GetElapsedTimeSec() << std::endl;
+
+	const int64_t wallTime = timer.GetElapsedTimeMicro() * 1000;
+	const size_t slowestCount = strtoul(options.options[Reflect::Reflect_CMD_Option_Report_Slowest].c_str(), nullptr, 10);
+	Reflect::Log::Flush();
+	if (options.options[Reflect::Reflect_CMD_Option_Quiet] != "true")
+	{
+		std::cout << Reflect::RunStats::Get().ToString(wallTime, slowestCount);
+	}
+
+	const std::string& reportJsonPath = options.options[Reflect::Reflect_CMD_Option_Report_Json];
+	if (!reportJsonPath.empty())
+	{
+		std::ofstream reportFile(reportJsonPath, std::ios::trunc);
+		if (reportFile.is_open())
+		{
+			reportFile << Reflect::RunStats::Get().ToJson(wallTime, slowestCount);
+			reportFile.close();
+		}
+		else
+		{
+			Log_Error("Could not write report to '%s'.", reportJsonPath.c_str());
+		}
+	}
 	REFLECT_PROFILE_END_SESSION();
 	REFLECT_PROFILE_SAVE_SESSION("ReflectEXE_Profile.json");
+	Reflect::Log::Shutdown();
 	return 0;
 }
\ No newline at end of file
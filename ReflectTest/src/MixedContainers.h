@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Reflect.h"
+#include "Generated/MixedContainers_reflect_generated.h"
+
+// Classes and structs mixed in one header. Each one is parsed in the order it is written.
+
+REFLECT_CLASS()
+class MixedFirstClass : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+public:
+	REFLECT_PROPERTY()
+	int First = 1;
+};
+
+REFLECT_STRUCT()
+struct MixedStruct : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	int Second = 2;
+};
+
+REFLECT_CLASS()
+class MixedSecondClass : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+public:
+	REFLECT_PROPERTY()
+	int Third = 3;
+};
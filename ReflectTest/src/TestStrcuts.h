@@ -2,6 +2,9 @@
 
 #include "Reflect.h"
 #include "Generated/TestStrcuts_reflect_generated.h"
+#include <vector>
+#include <map>
+#include <unordered_set>
 
 struct vec3
 {
@@ -44,6 +47,32 @@ struct S : REFLECT_BASE(), public Interface
 	vec3 vec = vec3(1);
 };
 
+REFLECT_STRUCT(Hashable)
+struct CacheKey : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	int Id = 0;
+	REFLECT_PROPERTY()
+	int Version = 0;
+	REFLECT_PROPERTY()
+	std::string Path;
+};
+
+REFLECT_STRUCT(Hashable)
+struct BundleKey : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	std::vector<CacheKey> Keys;
+	REFLECT_PROPERTY()
+	std::map<std::string, int> Tags;
+	REFLECT_PROPERTY()
+	std::unordered_set<std::string> Platforms;
+};
+
 class C
 {
 
@@ -80,4 +109,34 @@ private:
 		int Friends;
 	REFLECT_PROPERTY(Public)
 		int TimeOnline = 0;
-};
\ No newline at end of file
+};
+
+REFLECT_CLASS()
+class Enemy : public Player
+{
+	REFLECT_GENERATED_BODY()
+
+public:
+	REFLECT_PROPERTY(Public)
+	int Damage = 5;
+};
+
+// Player isn't a public base of these, so they keep the __super chain instead of flattened tables.
+REFLECT_CLASS()
+class Boss : private Player
+{
+	REFLECT_GENERATED_BODY()
+
+public:
+	REFLECT_PROPERTY(Public)
+	int Phase = 1;
+};
+
+REFLECT_STRUCT()
+struct Minion : protected Player
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY(Public)
+	int Leader = 0;
+};
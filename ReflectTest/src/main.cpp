@@ -1,6 +1,13 @@
 #include "Reflect.h"
 #include "TestStrcuts.h"
+#include "MixedContainers.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <unordered_map>
 
 void FuncNoReturn()
 {
@@ -100,6 +107,364 @@ void GetFunctionRefReturn()
 	stringRef = "ReferenceID";
 }
 
+void HashAndEquals()
+{
+	CacheKey key;
+	key.Id = 4;
+	key.Version = 2;
+	key.Path = "Assets/Player.mesh";
+	CacheKey sameKey = key;
+	CacheKey otherKey = key;
+	otherKey.Version = 3;
+
+	std::unordered_map<CacheKey, int, Reflect::Hash::Hasher<CacheKey>, Reflect::Hash::EqualTo<CacheKey>> cache;
+	cache[key] = 1;
+	cache[sameKey] = 2;
+	cache[otherKey] = 3;
+
+	std::cout << "CacheKey equals: " << key.Equals(sameKey) << ", not equals: " << key.Equals(otherKey) << '\n';
+	std::cout << "Cache size: " << cache.size() << '\n';
+
+	// Container members are hashed/compared element by element.
+	BundleKey bundle;
+	bundle.Keys = { key, otherKey };
+	bundle.Tags = { { "Lod", 0 }, { "Quality", 2 } };
+	bundle.Platforms = { "Windows", "Linux", "Mac" };
+	BundleKey sameBundle = bundle;
+	sameBundle.Platforms = { "Mac", "Linux", "Windows" };
+	BundleKey otherBundle = bundle;
+	otherBundle.Keys.pop_back();
+	std::cout << "BundleKey equals: " << bundle.Equals(sameBundle) << ", same hash: " << (bundle.Hash() == sameBundle.Hash())
+		<< ", not equals: " << bundle.Equals(otherBundle) << '\n';
+}
+
+void TypeRegistryLookup()
+{
+	const Reflect::TypeInfo* typeInfo = Reflect::TypeRegistry::Get().Find("Player");
+	if (typeInfo == nullptr || typeInfo != Reflect::TypeRegistry::Get().Find<Player>())
+	{
+		std::cout << "Player is not registered.\n";
+		return;
+	}
+
+	std::cout << "Type: " << typeInfo->GetName() << " Size: " << typeInfo->GetTypeSize() << '\n';
+	for (const std::string& base : typeInfo->GetInheritance())
+	{
+		std::cout << "\tBase: " << base << '\n';
+	}
+	for (const Reflect::ReflectMemberProp& member : typeInfo->GetMembers())
+	{
+		std::cout << "\tMember: " << member.Name << '\n';
+	}
+	for (const Reflect::ReflectFunctionProp& func : typeInfo->GetFunctions())
+	{
+		std::cout << "\tFunction: " << func.Name << '\n';
+	}
+
+	Reflect::IReflect* object = Reflect::TypeRegistry::Get().Create("Player");
+	std::cout << "Created type: " << object->GetTypeInfo()->GetName() << '\n';
+	typeInfo->Destroy(object);
+}
+
+void FactoryAllocators()
+{
+	const Reflect::TypeInfo* typeInfo = Reflect::TypeRegistry::Get().Find<Player>();
+
+	// Per type pool. Destroyed objects are recycled.
+	Reflect::PoolAllocator pool(typeInfo->GetTypeSize(), typeInfo->GetTypeAlignment());
+	std::vector<Reflect::IReflect*> pooledObjects;
+	for (int i = 0; i < 1000; ++i)
+	{
+		pooledObjects.push_back(typeInfo->Create(pool));
+	}
+	for (Reflect::IReflect* object : pooledObjects)
+	{
+		typeInfo->Destroy(object, pool);
+	}
+
+	// Arena. Everything is released when the arena is reset, the destructors are run then too.
+	Reflect::ArenaAllocator arena;
+	for (int i = 0; i < 1000; ++i)
+	{
+		Reflect::TypeRegistry::Get().Create("Player", arena);
+	}
+	// Also when the arena is only known as an IAllocator.
+	Reflect::IAllocator& allocator = arena;
+	Reflect::IReflect* arenaObject = typeInfo->Create(allocator);
+	// Does nothing, the arena runs the destructor once on Reset.
+	typeInfo->Destroy(arenaObject, allocator);
+	std::cout << "Arena bytes reserved: " << arena.GetBytesReserved() << '\n';
+	arena.Reset();
+
+	// A pool with blocks which are too small for the type gives no object.
+	Reflect::PoolAllocator smallPool(typeInfo->GetTypeSize() / 2, typeInfo->GetTypeAlignment());
+	std::cout << "Created from a too small pool: " << (typeInfo->Create(smallPool) != nullptr) << '\n';
+}
+
+void StaticReflection()
+{
+	// Resolved at compile time, no virtual calls or string lookups.
+	constexpr auto cacheKeyClass = Reflect::GetStaticClass<CacheKey>();
+	static_assert(cacheKeyClass.Name == "CacheKey");
+
+	CacheKey key;
+	key.Id = 7;
+	Reflect::ForEachMemberValue(key, [](const auto& member, auto& value)
+		{
+			using MemberType = typename std::decay_t<decltype(member)>::value_type;
+			if constexpr (std::is_same_v<MemberType, int>)
+			{
+				std::cout << member.Name << " (offset " << member.Offset << "): " << value << '\n';
+			}
+		});
+}
+
+void StaticLookup()
+{
+	// Same as the IReflect functions but without going through the vtable.
+	S s;
+	s.Friends = 3;
+	Reflect::ReflectMember friends = Reflect::ReflectStatic<S>::GetMember(s, "Friends");
+	std::cout << "Static GetMember: " << *friends.ConvertToType<int>() << '\n';
+	std::cout << "Static GetAllMembers: " << Reflect::ReflectStatic<S>::GetAllMembers(s).size() << '\n';
+
+	Player player;
+	Reflect::ReflectFunction printHelloWorld = Reflect::ReflectStatic<Player>::GetFunction(player, "PrintHelloWorld");
+	printHelloWorld.Invoke();
+	std::cout << '\n';
+}
+
+void AllMembersWithBases()
+{
+	// Enemy's tables have Player's members too, found when the headers were generated.
+	Enemy enemy;
+	for (const Reflect::ReflectMemberProp& member : Enemy::StaticTypeInfo().GetAllMembers())
+	{
+		std::cout << "\tMember: " << member.Name << '\n';
+	}
+	for (const Reflect::ReflectFunctionProp& func : Enemy::StaticTypeInfo().GetAllFunctions())
+	{
+		std::cout << "\tFunction: " << func.Name << '\n';
+	}
+
+	auto membersWithPublic = enemy.GetMembers({ "Public" });
+	std::cout << "Enemy public member count: " << membersWithPublic.size() << '\n';
+	std::cout << "Enemy static GetAllMembers: " << Reflect::ReflectStatic<Enemy>::GetAllMembers(enemy).size() << '\n';
+}
+
+void NonPublicBases()
+{
+	// Boss and Minion inherit Player privately/protected, their members are still found through __super.
+	Boss boss;
+	Minion minion;
+	std::cout << "Boss flattened: " << Boss::StaticTypeInfo().HasResolvedBases() << ", members: " << boss.GetAllMembers().size() << '\n';
+	std::cout << "Minion flattened: " << Minion::StaticTypeInfo().HasResolvedBases() << ", members: " << minion.GetAllMembers().size() << '\n';
+	for (Reflect::ReflectMember& member : boss.GetMembers({ "Public" }))
+	{
+		std::cout << "\tBoss public member: " << member.GetName() << '\n';
+	}
+
+	// ReflectStatic only sees their own members, the cast to a private/protected base doesn't compile outside the type.
+	boss.Phase = 2;
+	Reflect::ReflectMember phase = Reflect::ReflectStatic<Boss>::GetMember(boss, "Phase");
+	std::cout << "Boss static Phase: " << *phase.ConvertToType<int>() << ", static members: " << Reflect::ReflectStatic<Boss>::GetAllMembers(boss).size() << '\n';
+	std::cout << "Minion static members: " << Reflect::ReflectStatic<Minion>::GetAllMembers(minion).size() << '\n';
+}
+
+void MixedClassesAndStructs()
+{
+	// A class, a struct and a class in MixedContainers.h. All of them are reflected whatever order they are in.
+	for (const char* name : { "MixedFirstClass", "MixedStruct", "MixedSecondClass" })
+	{
+		const Reflect::TypeInfo* typeInfo = Reflect::TypeRegistry::Get().Find(name);
+		std::cout << name << " registered: " << (typeInfo != nullptr) << ", members: " << (typeInfo ? typeInfo->GetMembers().size() : 0) << '\n';
+	}
+}
+
+void ParsePropertiesWithoutFullExt()
+{
+	// Without reflect_full_ext only the REFLECT_PROPERTY() members are reflected. The search for them stops
+	// at the next container, so Second's property isn't added to First as well.
+	const std::filesystem::path headerPath = std::filesystem::temp_directory_path() / "ReflectTestProperties.h";
+	std::ofstream(headerPath) << R"(
+REFLECT_STRUCT()
+struct First : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	int A = 0;
+	int NotReflected = 0;
+};
+
+REFLECT_STRUCT()
+struct Second : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY()
+	int B = 0;
+};
+)";
+
+	Reflect::FileParser parser;
+	parser.SetOptions(Reflect::ReflectAddtionalOptions());
+	Reflect::FileParsedData data;
+	parser.ParseFile(headerPath.generic_u8string(), data);
+	for (const Reflect::ReflectContainerData& container : data.ReflectData)
+	{
+		std::cout << "Parsed " << container.Name.Get() << " members: " << container.Members.size() << '\n';
+	}
+	std::filesystem::remove(headerPath);
+}
+
+void UnityFilesWithFileList()
+{
+	// The unity files of a directory have the code of every header in it. A file_list run which only names
+	// First.h is refused, otherwise it would write them with only First's code and Second's would be lost.
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "ReflectTestUnity";
+	std::filesystem::create_directories(directory);
+	for (const char* name : { "First", "Second" })
+	{
+		std::ofstream(directory / (std::string(name) + ".h")) << "#pragma once\n\nREFLECT_STRUCT()\nstruct " << name
+			<< " : REFLECT_BASE()\n{\n\tREFLECT_GENERATED_BODY()\n\n\tint Value = 0;\n};\n";
+	}
+	const std::filesystem::path listPath = directory / "headers.rsp";
+	std::ofstream(listPath) << (directory / "First.h").generic_u8string() << '\n';
+
+	Reflect::ReflectAddtionalOptions options;
+	options.options[Reflect::Reflect_CMD_Option_Reflect_Full_EXT] = "true";
+	options.options[Reflect::Reflect_CMD_Option_Unity_Files] = "1";
+	{
+		Reflect::FileParser parser;
+		Reflect::ReflectPipeline(parser, options).Run(parser.CollectFiles(directory.generic_u8string()));
+	}
+
+	options.options[Reflect::Reflect_CMD_Option_File_List] = listPath.generic_u8string();
+	Reflect::FileParser parser;
+	const bool listRun = Reflect::ReflectPipeline(parser, options).Run(parser.CollectFilesFromList(listPath.generic_u8string()));
+
+	std::ifstream unityFile(directory / "Generated" / (std::string(Reflect::ReflectUnityFilePrefix) + "0" + Reflect::ReflectFileGeneratePrefix + ".cpp"));
+	const std::string unitySource((std::istreambuf_iterator<char>(unityFile)), std::istreambuf_iterator<char>());
+	std::cout << "unity_files with file_list ran: " << listRun << ", Second kept: " << (unitySource.find("// Second.h") != std::string::npos) << '\n';
+	unityFile.close();
+	std::filesystem::remove_all(directory);
+}
+
+bool SameTypeNames(const Reflect::ModelVector<Reflect::ReflectMemberData>& parsed, const Reflect::ModelVector<Reflect::ReflectMemberData>& loaded)
+{
+	return parsed.size() == loaded.size() && std::equal(parsed.begin(), parsed.end(), loaded.begin(), [](const auto& a, const auto& b)
+	{
+		return !(a != b) && a.ReflectValueType == b.ReflectValueType && a.ReflectModifier == b.ReflectModifier && a.IsConst == b.IsConst;
+	});
+}
+
+bool SameContainers(const Reflect::ReflectContainerData& parsed, const Reflect::ReflectContainerData& loaded)
+{
+	return parsed.Name == loaded.Name
+		&& parsed.PrettyName == loaded.PrettyName
+		&& parsed.Type == loaded.Type
+		&& parsed.ContainerProps == loaded.ContainerProps
+		&& parsed.Inheritance == loaded.Inheritance
+		&& parsed.InheritanceAccess == loaded.InheritanceAccess
+		&& parsed.ReflectType == loaded.ReflectType
+		&& parsed.ReflectGenerateBodyLine == loaded.ReflectGenerateBodyLine
+		&& SameTypeNames(parsed.Members, loaded.Members)
+		&& parsed.Functions.size() == loaded.Functions.size()
+		&& std::equal(parsed.Functions.begin(), parsed.Functions.end(), loaded.Functions.begin(), [](const auto& a, const auto& b)
+		{
+			return !(a != b) && a.Parameters.size() == b.Parameters.size()
+				&& std::equal(a.Parameters.begin(), a.Parameters.end(), b.Parameters.begin(), [](const auto& x, const auto& y) { return !(x != y); });
+		});
+}
+
+void DatabaseRoundTrip()
+{
+	// Write the parsed model of a header to a database, open it again and check it reads back the same.
+	// A truncated database and one of another version are refused by Open.
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "ReflectTestDatabase";
+	std::filesystem::create_directories(directory);
+	const std::filesystem::path headerPath = directory / "Round.h";
+	std::ofstream(headerPath) << R"(#pragma once
+#include "Round.reflect.h"
+
+REFLECT_STRUCT(Saved)
+struct RoundBase : REFLECT_BASE()
+{
+	REFLECT_GENERATED_BODY()
+
+	REFLECT_PROPERTY(EditorOnly, Public)
+	int Health = 0;
+};
+
+REFLECT_CLASS()
+class RoundDerived : public RoundBase, private Reflect::IReflect
+{
+	REFLECT_GENERATED_BODY()
+
+public:
+	REFLECT_PROPERTY()
+	const std::string* Name = nullptr;
+
+	REFLECT_PROPERTY()
+	float Speed(int level, const std::vector<int>& scale);
+};
+)";
+
+	Reflect::ReflectAddtionalOptions options;
+	options.options[Reflect::Reflect_CMD_Option_Reflect_Full_EXT] = "true";
+	Reflect::FileParser parser;
+	parser.SetOptions(options);
+	Reflect::FileParsedData parsed;
+	parser.ParseFile(headerPath.generic_u8string(), parsed);
+
+	const std::string databasePath = (directory / (std::string("Round") + Reflect::DatabaseFormat::FileExtension)).generic_u8string();
+	Reflect::ReflectDatabaseWriter writer;
+	writer.AddFile(parsed);
+	const bool written = writer.Write(databasePath);
+
+	bool roundTrip = false;
+	{
+		Reflect::ReflectDatabase database;
+		const bool opened = database.Open(databasePath);
+		const Reflect::DatabaseFormat::Container* derived = opened ? database.FindContainer("RoundDerived") : nullptr;
+		const Reflect::DatabaseFormat::File* file = opened ? database.FindFile(headerPath.generic_u8string()) : nullptr;
+		if (derived != nullptr && file != nullptr)
+		{
+			Reflect::FileParsedData loaded;
+			database.GetFileParsedData(*file, loaded);
+			roundTrip = database.GetMembers(*derived).size() == parsed.ReflectData.back().Members.size()
+				&& loaded.FilePath == parsed.FilePath
+				&& loaded.FileName == parsed.FileName
+				&& loaded.CPPIncludes == parsed.CPPIncludes
+				&& loaded.ReflectData.size() == parsed.ReflectData.size()
+				&& std::equal(parsed.ReflectData.begin(), parsed.ReflectData.end(), loaded.ReflectData.begin(), SameContainers);
+		}
+		std::cout << "Database written: " << written << ", FindContainer missing: " << (database.FindContainer("RoundMissing") == nullptr)
+			<< ", round trip: " << roundTrip << '\n';
+	}
+
+	std::ifstream databaseFile(databasePath, std::ios::binary);
+	const std::string bytes((std::istreambuf_iterator<char>(databaseFile)), std::istreambuf_iterator<char>());
+	databaseFile.close();
+
+	const std::filesystem::path truncatedPath = directory / "Truncated.rdb";
+	std::ofstream(truncatedPath, std::ios::binary).write(bytes.data(), bytes.size() / 2);
+	std::string otherVersion = bytes;
+	const uint32_t version = Reflect::DatabaseFormat::Version + 1;
+	std::memcpy(&otherVersion[offsetof(Reflect::DatabaseFormat::Header, Version)], &version, sizeof(version));
+	const std::filesystem::path versionPath = directory / "OtherVersion.rdb";
+	std::ofstream(versionPath, std::ios::binary).write(otherVersion.data(), otherVersion.size());
+
+	for (const std::filesystem::path& path : { truncatedPath, versionPath })
+	{
+		Reflect::ReflectDatabase database;
+		const bool opened = database.Open(path.generic_u8string());
+		std::cout << path.filename().generic_u8string() << " opened: " << opened << " (" << database.GetError() << ")\n";
+	}
+	std::filesystem::remove_all(directory);
+}
+
 int main(void)
 {
 	FuncNoReturn();
@@ -107,7 +472,19 @@ int main(void)
 	FuncWithParameters();
 	GetMemberWithFlags();
 	GetAllMemebers();
+	HashAndEquals();
+	TypeRegistryLookup();
+	FactoryAllocators();
+	StaticReflection();
+	StaticLookup();
+	AllMembersWithBases();
+	NonPublicBases();
+	MixedClassesAndStructs();
+	ParsePropertiesWithoutFullExt();
+	UnityFilesWithFileList();
+	DatabaseRoundTrip();
 	//GetFunctionRefReturn();
 
+	Reflect::Log::Shutdown();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+project "ReflectTraceConverter"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+	staticruntime "on"
+
+    targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+    debugdir ("../bin/" .. outputdir .. "/%{prj.name}")
+
+    files
+	{
+        "src/*.cpp",
+	}
+
+    includedirs 
+    {
+        "../Reflect/inc",
+	}
+
+    filter "system:windows"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {  
+            "PLATFORM_WINDWOS",
+        }
+
+    filter "configurations:Debug"
+        defines 
+        { 
+            "DEBUG",
+        }
+        symbols "on"
+
+    filter "configurations:Release"
+        defines 
+        { 
+            "RELEASE",
+        }
+        optimize "on"
+
+    filter "configurations:Dist"
+        defines 
+        { 
+            "DIST"
+        }
+        optimize "full"
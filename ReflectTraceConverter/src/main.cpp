@@ -0,0 +1,67 @@
+#include "TraceFormat.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Expand a binary trace written by Instrumentor::SaveSessionBinary into Chrome trace/Perfetto json.
+// Usage: ReflectTraceConverter input.rtrace [output.json]
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: ReflectTraceConverter input" << Reflect::Profile::TraceFormat::FileExtension << " [output.json]" << std::endl;
+		return 1;
+	}
+
+	std::string inputPath = argv[1];
+	std::string outputPath = argc > 2 ? argv[2] : inputPath.substr(0, inputPath.find_last_of('.')) + ".json";
+
+	std::ifstream iFile(inputPath, std::ios::binary);
+	if (!iFile.is_open())
+	{
+		std::cout << "Could not open '" << inputPath << "'." << std::endl;
+		return 1;
+	}
+	iFile.seekg(0, iFile.end);
+	size_t size = iFile.tellg();
+	iFile.seekg(0, iFile.beg);
+
+	std::string data;
+	data.resize(size);
+	iFile.read(data.data(), size);
+	iFile.close();
+
+	Reflect::Profile::TraceFormat::Reader reader;
+	if (!reader.Read(data))
+	{
+		std::cout << "Could not read '" << inputPath << "': " << reader.GetError() << std::endl;
+		return 1;
+	}
+
+	std::string json;
+	json.reserve(reader.GetEvents().size() * 96 + 128);
+	json += "{\"otherData\": {\"droppedEvents\":" + std::to_string(reader.GetDroppedCount()) + "},\"traceEvents\":[{}";
+	for (const auto& thread : reader.GetThreadNames())
+	{
+		json += ',';
+		Reflect::Profile::WriteThreadNameJson(json, thread.ThreadId, thread.Name);
+	}
+	for (const Reflect::Profile::ProfileEvent& event : reader.GetEvents())
+	{
+		json += ',';
+		Reflect::Profile::WriteEventJson(json, event);
+	}
+	json += "]}";
+
+	std::ofstream oFile(outputPath, std::ios::binary | std::ios::trunc);
+	if (!oFile.is_open())
+	{
+		std::cout << "Could not write '" << outputPath << "'." << std::endl;
+		return 1;
+	}
+	oFile.write(json.data(), json.size());
+	oFile.close();
+
+	std::cout << "Converted " << reader.GetEvents().size() << " events (" << size << " bytes) to '" << outputPath << "' (" << json.size() << " bytes)." << std::endl;
+	return 0;
+}
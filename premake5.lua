@@ -1,3 +1,21 @@
+newoption
+{
+    trigger = "profile-release",
+    description = "Compile the REFLECT_PROFILE_* instrumentation into Release and Dist builds"
+}
+
+newoption
+{
+    trigger = "profile-rdtsc",
+    description = "Use rdtsc instead of std::chrono::steady_clock for profile timestamps"
+}
+
+newoption
+{
+    trigger = "track-allocations",
+    description = "Replace the global operator new to count allocations for the run report and the profiler's Memory track"
+}
+
 workspace "Reflect"
     architecture "x64"
     startproject "ReflectTest"
@@ -18,6 +36,17 @@ workspace "Reflect"
     {
     }
 
+    filter "options:profile-release"
+        defines { "REFLECT_PROFILE_RELEASE" }
+
+    filter "options:profile-rdtsc"
+        defines { "REFLECT_PROFILE_USE_RDTSC" }
+
+    filter "options:track-allocations"
+        defines { "REFLECT_TRACK_ALLOCATIONS" }
+
+    filter {}
+
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 -- Include directories relative to root folder (solution directory)
@@ -30,4 +59,7 @@ group ""
 
 include "Reflect"
 include "ReflectEXE"
-include "ReflectTest"
\ No newline at end of file
+include "ReflectTest"
+include "ReflectTraceConverter"
+include "ReflectBenchmark"
+include "ReflectCorpusBenchmark"
\ No newline at end of file